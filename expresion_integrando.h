@@ -0,0 +1,405 @@
+/******************************************************************************
+ * INTEGRANDOS DEFINIDOS EN TIEMPO DE EJECUCIÓN
+ *****************************************************************************
+ *
+ * Compila una expresión de texto ("4*sqrt(1-x*x)", "exp(-(x^2+y^2))", ...) a
+ * un código de bytes para una máquina de pila, y lo evalúa por lotes: cada
+ * instrucción recorre todo el lote de puntos antes de pasar a la siguiente,
+ * así que el bucle interno es una operación aritmética sobre arrays contiguos
+ * que el compilador vectoriza (SIMD a lo ancho del lote, no dentro de una
+ * muestra). El coste de interpretar cada instrucción se reparte entre todos
+ * los puntos del lote.
+ *
+ * Se usa como integrando por lotes de integrar() (integrador_montecarlo.h).
+ *
+ * Gramática (de menor a mayor precedencia):
+ *   comparación:  suma [(< | <= | > | >=) suma]      (vale 1 o 0)
+ *   suma:         término {(+ | -) término}
+ *   término:      unario {(* | /) unario}
+ *   unario:       - unario | potencia
+ *   potencia:     primario [^ unario]                (asociativa por la derecha)
+ *   primario:     número | variable | constante | función(args) | (comparación)
+ * Variables: x, y, z, w (coordenadas 0 a 3) o x0 ... x7. Constantes: pi, e.
+ * Funciones: sqrt exp log sin cos tan atan abs (un argumento), min max pow (dos).
+ *
+ * Las subexpresiones constantes se calculan al compilar, y x^2 / x^3 con
+ * exponente constante se evalúan con productos en lugar de pow.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+// Máximo de coordenadas que puede usar una expresión
+const int VARIABLES_EXPRESION = 8;
+
+// Puntos que se evalúan de cada vez (los lotes más grandes se parten)
+const int LOTE_EXPRESION = 128;
+
+enum OpExpresion {
+	OP_CONSTANTE, OP_VARIABLE,
+	OP_SUMA, OP_RESTA, OP_PRODUCTO, OP_COCIENTE, OP_POTENCIA, OP_MINIMO, OP_MAXIMO,
+	OP_MENOR, OP_MENOR_IGUAL, OP_MAYOR, OP_MAYOR_IGUAL,
+	OP_NEGACION, OP_CUADRADO, OP_CUBO,
+	OP_RAIZ, OP_EXP, OP_LOG, OP_SENO, OP_COSENO, OP_TANGENTE, OP_ARCOTANGENTE, OP_ABS
+};
+
+// Una instrucción lee los registros a (y b) y escribe en destino. Los registros
+// son las posiciones de la pila: en una expresión bien formada cada operación
+// binaria consume los dos registros superiores y deja el resultado en el primero.
+struct InstruccionExpresion {
+	int op;
+	int destino;
+	int a, b;
+	double valor;     // OP_CONSTANTE: la constante; OP_VARIABLE: índice de la coordenada
+};
+
+class ExpresionCompilada {
+public:
+	/**
+	 * Compila el texto a código de bytes
+	 *
+	 * @param texto: Expresión
+	 * @param error: Mensaje si no se puede compilar (con la posición del fallo)
+	 * @return true si la expresión es válida
+	 */
+	bool compilar(const std::string& texto, std::string& error) {
+		texto_ = texto;
+		pos_ = 0;
+		codigo_.clear();
+		es_constante_.clear();
+		profundidad_ = 0;
+		max_profundidad_ = 0;
+		dimension_ = 0;
+		error_.clear();
+
+		if (comparacion() && saltar_espacios() < texto_.size()) {
+			fallo("caracter inesperado");
+		}
+		if (!error_.empty()) {
+			error = error_ + " (posicion " + std::to_string(pos_ + 1) + ")";
+			codigo_.clear();
+			return false;
+		}
+		registros_.assign((size_t)max_profundidad_ * LOTE_EXPRESION, 0.0);
+		return true;
+	}
+
+	// Coordenadas que usa la expresión (índice de la mayor variable + 1)
+	int dimension() const { return dimension_; }
+	int instrucciones() const { return (int)codigo_.size(); }
+
+	// Separación entre puntos consecutivos en el array de coordenadas (por defecto, dimension())
+	void fijar_paso(int paso) { paso_ = paso; }
+
+	/**
+	 * Evalúa la expresión en n puntos (forma por lotes de integrar)
+	 *
+	 * @param puntos: n puntos seguidos, 'paso' coordenadas cada uno
+	 * @param valores: Resultado, n valores
+	 */
+	void operator()(const double* puntos, int n, double* valores) {
+		int paso = paso_ > 0 ? paso_ : dimension_;
+		for (int inicio = 0; inicio < n; inicio += LOTE_EXPRESION) {
+			int lote = n - inicio < LOTE_EXPRESION ? n - inicio : LOTE_EXPRESION;
+			evaluar_lote(puntos + (size_t)inicio * paso, paso, lote);
+			const double* r = registros_.data();
+			for (int k = 0; k < lote; ++k) {
+				valores[inicio + k] = r[k];
+			}
+		}
+	}
+
+private:
+	// Ejecuta el código sobre un lote: cada instrucción es un bucle sobre los puntos
+	void evaluar_lote(const double* puntos, int paso, int n) {
+		double* base = registros_.data();
+		for (size_t i = 0; i < codigo_.size(); ++i) {
+			const InstruccionExpresion& ins = codigo_[i];
+			double* d = base + (size_t)ins.destino * LOTE_EXPRESION;
+			const double* a = base + (size_t)ins.a * LOTE_EXPRESION;
+			const double* b = base + (size_t)ins.b * LOTE_EXPRESION;
+			int k;
+			switch (ins.op) {
+			case OP_CONSTANTE: for (k = 0; k < n; ++k) d[k] = ins.valor; break;
+			case OP_VARIABLE: {
+				const double* p = puntos + (int)ins.valor;
+				for (k = 0; k < n; ++k) d[k] = p[(size_t)k * paso];
+				break;
+			}
+			case OP_SUMA: for (k = 0; k < n; ++k) d[k] = a[k] + b[k]; break;
+			case OP_RESTA: for (k = 0; k < n; ++k) d[k] = a[k] - b[k]; break;
+			case OP_PRODUCTO: for (k = 0; k < n; ++k) d[k] = a[k] * b[k]; break;
+			case OP_COCIENTE: for (k = 0; k < n; ++k) d[k] = a[k] / b[k]; break;
+			case OP_POTENCIA: for (k = 0; k < n; ++k) d[k] = pow(a[k], b[k]); break;
+			case OP_MINIMO: for (k = 0; k < n; ++k) d[k] = a[k] < b[k] ? a[k] : b[k]; break;
+			case OP_MAXIMO: for (k = 0; k < n; ++k) d[k] = a[k] > b[k] ? a[k] : b[k]; break;
+			case OP_MENOR: for (k = 0; k < n; ++k) d[k] = a[k] < b[k] ? 1.0 : 0.0; break;
+			case OP_MENOR_IGUAL: for (k = 0; k < n; ++k) d[k] = a[k] <= b[k] ? 1.0 : 0.0; break;
+			case OP_MAYOR: for (k = 0; k < n; ++k) d[k] = a[k] > b[k] ? 1.0 : 0.0; break;
+			case OP_MAYOR_IGUAL: for (k = 0; k < n; ++k) d[k] = a[k] >= b[k] ? 1.0 : 0.0; break;
+			case OP_NEGACION: for (k = 0; k < n; ++k) d[k] = -a[k]; break;
+			case OP_CUADRADO: for (k = 0; k < n; ++k) d[k] = a[k] * a[k]; break;
+			case OP_CUBO: for (k = 0; k < n; ++k) d[k] = a[k] * a[k] * a[k]; break;
+			case OP_RAIZ: for (k = 0; k < n; ++k) d[k] = sqrt(a[k]); break;
+			case OP_EXP: for (k = 0; k < n; ++k) d[k] = exp(a[k]); break;
+			case OP_LOG: for (k = 0; k < n; ++k) d[k] = log(a[k]); break;
+			case OP_SENO: for (k = 0; k < n; ++k) d[k] = sin(a[k]); break;
+			case OP_COSENO: for (k = 0; k < n; ++k) d[k] = cos(a[k]); break;
+			case OP_TANGENTE: for (k = 0; k < n; ++k) d[k] = tan(a[k]); break;
+			case OP_ARCOTANGENTE: for (k = 0; k < n; ++k) d[k] = atan(a[k]); break;
+			case OP_ABS: for (k = 0; k < n; ++k) d[k] = fabs(a[k]); break;
+			}
+		}
+	}
+
+	// Valor de una operación con operandos constantes (plegado al compilar)
+	static double aplicar(int op, double a, double b) {
+		switch (op) {
+		case OP_SUMA: return a + b;
+		case OP_RESTA: return a - b;
+		case OP_PRODUCTO: return a * b;
+		case OP_COCIENTE: return a / b;
+		case OP_POTENCIA: return pow(a, b);
+		case OP_MINIMO: return a < b ? a : b;
+		case OP_MAXIMO: return a > b ? a : b;
+		case OP_MENOR: return a < b ? 1.0 : 0.0;
+		case OP_MENOR_IGUAL: return a <= b ? 1.0 : 0.0;
+		case OP_MAYOR: return a > b ? 1.0 : 0.0;
+		case OP_MAYOR_IGUAL: return a >= b ? 1.0 : 0.0;
+		case OP_NEGACION: return -a;
+		case OP_CUADRADO: return a * a;
+		case OP_CUBO: return a * a * a;
+		case OP_RAIZ: return sqrt(a);
+		case OP_EXP: return exp(a);
+		case OP_LOG: return log(a);
+		case OP_SENO: return sin(a);
+		case OP_COSENO: return cos(a);
+		case OP_TANGENTE: return tan(a);
+		case OP_ARCOTANGENTE: return atan(a);
+		default: return fabs(a);
+		}
+	}
+
+	// Emisión de código. La pila de compilación recuerda qué registros son constantes.
+	void emitir_constante(double valor) {
+		InstruccionExpresion ins = { OP_CONSTANTE, profundidad_, 0, 0, valor };
+		codigo_.push_back(ins);
+		es_constante_.push_back(true);
+		if (++profundidad_ > max_profundidad_) max_profundidad_ = profundidad_;
+	}
+
+	void emitir_variable(int indice) {
+		InstruccionExpresion ins = { OP_VARIABLE, profundidad_, 0, 0, (double)indice };
+		codigo_.push_back(ins);
+		es_constante_.push_back(false);
+		if (indice + 1 > dimension_) dimension_ = indice + 1;
+		if (++profundidad_ > max_profundidad_) max_profundidad_ = profundidad_;
+	}
+
+	void emitir_unaria(int op) {
+		if (es_constante_.back()) {
+			double valor = codigo_.back().valor;
+			codigo_.pop_back();
+			es_constante_.pop_back();
+			profundidad_--;
+			emitir_constante(aplicar(op, valor, 0.0));
+			return;
+		}
+		InstruccionExpresion ins = { op, profundidad_ - 1, profundidad_ - 1, 0, 0.0 };
+		codigo_.push_back(ins);
+	}
+
+	void emitir_binaria(int op) {
+		bool a_constante = es_constante_[es_constante_.size() - 2];
+		bool b_constante = es_constante_.back();
+		if (a_constante && b_constante) {
+			double b = codigo_.back().valor;
+			codigo_.pop_back();
+			double a = codigo_.back().valor;
+			codigo_.pop_back();
+			es_constante_.pop_back();
+			es_constante_.pop_back();
+			profundidad_ -= 2;
+			emitir_constante(aplicar(op, a, b));
+			return;
+		}
+		// Potencias pequeñas con exponente constante: productos en lugar de pow
+		if (op == OP_POTENCIA && b_constante && (codigo_.back().valor == 2.0 || codigo_.back().valor == 3.0)) {
+			int potencia = codigo_.back().valor == 2.0 ? OP_CUADRADO : OP_CUBO;
+			codigo_.pop_back();
+			es_constante_.pop_back();
+			profundidad_--;
+			emitir_unaria(potencia);
+			return;
+		}
+		es_constante_.pop_back();
+		es_constante_.back() = false;
+		profundidad_--;
+		InstruccionExpresion ins = { op, profundidad_ - 1, profundidad_ - 1, profundidad_, 0.0 };
+		codigo_.push_back(ins);
+	}
+
+	// Analizador descendente recursivo: cada regla deja su valor en la cima de la pila
+	size_t saltar_espacios() {
+		while (pos_ < texto_.size() && isspace((unsigned char)texto_[pos_])) pos_++;
+		return pos_;
+	}
+
+	bool aceptar(const char* simbolo) {
+		saltar_espacios();
+		size_t n = strlen(simbolo);
+		if (texto_.compare(pos_, n, simbolo) == 0) {
+			pos_ += n;
+			return true;
+		}
+		return false;
+	}
+
+	bool fallo(const char* mensaje) {
+		if (error_.empty()) error_ = mensaje;
+		return false;
+	}
+
+	bool comparacion() {
+		if (!suma()) return false;
+		int op = -1;
+		if (aceptar("<=")) op = OP_MENOR_IGUAL;
+		else if (aceptar(">=")) op = OP_MAYOR_IGUAL;
+		else if (aceptar("<")) op = OP_MENOR;
+		else if (aceptar(">")) op = OP_MAYOR;
+		if (op < 0) return true;
+		if (!suma()) return false;
+		emitir_binaria(op);
+		return true;
+	}
+
+	bool suma() {
+		if (!termino()) return false;
+		for (;;) {
+			int op;
+			if (aceptar("+")) op = OP_SUMA;
+			else if (aceptar("-")) op = OP_RESTA;
+			else return true;
+			if (!termino()) return false;
+			emitir_binaria(op);
+		}
+	}
+
+	bool termino() {
+		if (!unario()) return false;
+		for (;;) {
+			int op;
+			if (aceptar("*")) op = OP_PRODUCTO;
+			else if (aceptar("/")) op = OP_COCIENTE;
+			else return true;
+			if (!unario()) return false;
+			emitir_binaria(op);
+		}
+	}
+
+	bool unario() {
+		if (aceptar("-")) {
+			if (!unario()) return false;
+			emitir_unaria(OP_NEGACION);
+			return true;
+		}
+		if (aceptar("+")) return unario();
+		return potencia();
+	}
+
+	bool potencia() {
+		if (!primario()) return false;
+		if (aceptar("^")) {
+			if (!unario()) return false;
+			emitir_binaria(OP_POTENCIA);
+		}
+		return true;
+	}
+
+	bool primario() {
+		saltar_espacios();
+		if (pos_ >= texto_.size()) return fallo("expresion incompleta");
+		char c = texto_[pos_];
+
+		if (isdigit((unsigned char)c) || c == '.') {
+			const char* inicio = texto_.c_str() + pos_;
+			char* fin;
+			double valor = strtod(inicio, &fin);
+			if (fin == inicio) return fallo("numero no valido");
+			pos_ += fin - inicio;
+			emitir_constante(valor);
+			return true;
+		}
+
+		if (aceptar("(")) {
+			if (!comparacion()) return false;
+			if (!aceptar(")")) return fallo("falta ')'");
+			return true;
+		}
+
+		if (!isalpha((unsigned char)c)) return fallo("se esperaba un numero, variable o funcion");
+		size_t inicio = pos_;
+		while (pos_ < texto_.size() && isalnum((unsigned char)texto_[pos_])) pos_++;
+		std::string nombre = texto_.substr(inicio, pos_ - inicio);
+
+		// Variables y constantes
+		const char* const COORDENADAS[] = { "x", "y", "z", "w" };
+		for (int d = 0; d < 4; ++d) {
+			if (nombre == COORDENADAS[d]) {
+				emitir_variable(d);
+				return true;
+			}
+		}
+		if (nombre.size() == 2 && nombre[0] == 'x' && nombre[1] >= '0' && nombre[1] < '0' + VARIABLES_EXPRESION) {
+			emitir_variable(nombre[1] - '0');
+			return true;
+		}
+		if (nombre == "pi") {
+			emitir_constante(3.14159265358979323846);
+			return true;
+		}
+		if (nombre == "e") {
+			emitir_constante(2.71828182845904523536);
+			return true;
+		}
+
+		// Funciones
+		struct Funcion { const char* nombre; int op; int argumentos; };
+		const Funcion FUNCIONES[] = {
+			{ "sqrt", OP_RAIZ, 1 }, { "exp", OP_EXP, 1 }, { "log", OP_LOG, 1 },
+			{ "sin", OP_SENO, 1 }, { "cos", OP_COSENO, 1 }, { "tan", OP_TANGENTE, 1 },
+			{ "atan", OP_ARCOTANGENTE, 1 }, { "abs", OP_ABS, 1 },
+			{ "min", OP_MINIMO, 2 }, { "max", OP_MAXIMO, 2 }, { "pow", OP_POTENCIA, 2 } };
+		for (const Funcion& f : FUNCIONES) {
+			if (nombre != f.nombre) continue;
+			if (!aceptar("(")) return fallo("falta '(' tras el nombre de la funcion");
+			for (int k = 0; k < f.argumentos; ++k) {
+				if (k > 0 && !aceptar(",")) return fallo("faltan argumentos");
+				if (!comparacion()) return false;
+			}
+			if (!aceptar(")")) return fallo("falta ')'");
+			if (f.argumentos == 1) emitir_unaria(f.op);
+			else emitir_binaria(f.op);
+			return true;
+		}
+		pos_ = inicio;
+		return fallo("nombre desconocido");
+	}
+
+	std::string texto_;
+	size_t pos_ = 0;
+	std::string error_;
+	std::vector<InstruccionExpresion> codigo_;
+	std::vector<bool> es_constante_;
+	int profundidad_ = 0;
+	int max_profundidad_ = 0;
+	int dimension_ = 0;
+	int paso_ = 0;
+	std::vector<double> registros_;  // max_profundidad_ registros de LOTE_EXPRESION valores
+};
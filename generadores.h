@@ -0,0 +1,558 @@
+/******************************************************************************
+ * GENERADORES DE NÚMEROS ALEATORIOS PROPIOS
+ *****************************************************************************
+ *
+ * Generadores pensados para el bucle de muestreo, además de los de <random>.
+ * Todos cumplen los requisitos de UniformRandomBitGenerator (result_type,
+ * min(), max() y operator()), así que funcionan con uniform_real_distribution
+ * y con cualquier variante de nucleos_montecarlo.h, y se siembran con
+ * std::seed_seq igual que los motores estándar (ver sembrar_bloque).
+ *
+ * Los que producen varias palabras por llamada ofrecen además una
+ * sobrecarga de rellenar_palabras, que la tubería con búfer usa para llenar el
+ * búfer de golpe en lugar de palabra a palabra.
+ */
+
+#pragma once
+
+#include <random>
+#include <stdint.h>
+
+/**
+ * XOSHIRO256+ CON L CARRILES EN FORMATO SoA
+ *
+ * El estado de mt19937 ocupa 624 palabras y cada salida depende de la anterior,
+ * así que no se vectoriza. xoshiro256+ tiene 4 palabras de estado y solo usa
+ * sumas, desplazamientos y XOR; guardando L generadores independientes como
+ * cuatro arrays de L palabras (s0[0..L), s1[0..L), ...), el paso de los L
+ * carriles es un bucle sin dependencias entre iteraciones que el compilador
+ * convierte en instrucciones SIMD, y cada llamada produce L palabras.
+ *
+ * Siembra: seed_seq da el estado del carril 0 y cada carril siguiente es el
+ * anterior avanzado con la función de salto (2^128 pasos), por lo que las
+ * secuencias de los carriles de un mismo generador nunca se solapan.
+ *
+ * Los 3 bits bajos de xoshiro256+ tienen poca complejidad lineal; las
+ * conversiones a real usan los bits altos, salvo la coordenada y de
+ * dividido-64, donde esos bits pesan menos de 2^-29.
+ */
+template <int L>
+class XoshiroSoA {
+public:
+	typedef uint64_t result_type;
+	static const int carriles = L;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~(uint64_t)0; }
+
+	XoshiroSoA() {
+		std::seed_seq secuencia{ 0u };
+		seed(secuencia);
+	}
+
+	void seed(std::seed_seq& secuencia) {
+		uint32_t palabras[8];
+		secuencia.generate(palabras, palabras + 8);
+		uint64_t estado[4];
+		for (int i = 0; i < 4; ++i) {
+			estado[i] = (uint64_t)palabras[2 * i] | ((uint64_t)palabras[2 * i + 1] << 32);
+		}
+		if ((estado[0] | estado[1] | estado[2] | estado[3]) == 0) {
+			estado[0] = 1;  // El estado todo a cero es el único prohibido
+		}
+		for (int k = 0; k < L; ++k) {
+			s0[k] = estado[0]; s1[k] = estado[1]; s2[k] = estado[2]; s3[k] = estado[3];
+			saltar(estado);
+		}
+		pendientes = 0;
+	}
+
+	// Avanza los L carriles un paso y escribe sus L salidas en 'destino'
+	void siguiente_vector(uint64_t* destino) {
+		for (int k = 0; k < L; ++k) {
+			destino[k] = s0[k] + s3[k];
+			uint64_t t = s1[k] << 17;
+			s2[k] ^= s0[k];
+			s3[k] ^= s1[k];
+			s1[k] ^= s2[k];
+			s0[k] ^= s3[k];
+			s2[k] ^= t;
+			s3[k] = (s3[k] << 45) | (s3[k] >> 19);
+		}
+	}
+
+	// Una palabra cada vez: reparte las del último vector generado
+	result_type operator()() {
+		if (pendientes == 0) {
+			siguiente_vector(salida);
+			pendientes = L;
+		}
+		return salida[L - pendientes--];
+	}
+
+	void discard(unsigned long long n) {
+		for (; n > 0; --n) {
+			(*this)();
+		}
+	}
+
+	// Palabras del último vector que aún no se han entregado
+	int palabras_pendientes() const { return pendientes; }
+
+private:
+	alignas(64) uint64_t s0[L];
+	alignas(64) uint64_t s1[L];
+	alignas(64) uint64_t s2[L];
+	alignas(64) uint64_t s3[L];
+	alignas(64) uint64_t salida[L];
+	int pendientes;
+
+	// Función de salto de xoshiro256: equivale a 2^128 llamadas
+	static void saltar(uint64_t estado[4]) {
+		static const uint64_t SALTO[] = {
+			0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+		uint64_t t[4] = { 0, 0, 0, 0 };
+		for (int i = 0; i < 4; ++i) {
+			for (int b = 0; b < 64; ++b) {
+				if (SALTO[i] & ((uint64_t)1 << b)) {
+					for (int j = 0; j < 4; ++j) t[j] ^= estado[j];
+				}
+				uint64_t u = estado[1] << 17;  // Un paso escalar (sin calcular la salida)
+				estado[2] ^= estado[0];
+				estado[3] ^= estado[1];
+				estado[1] ^= estado[2];
+				estado[0] ^= estado[3];
+				estado[2] ^= u;
+				estado[3] = (estado[3] << 45) | (estado[3] >> 19);
+			}
+		}
+		for (int j = 0; j < 4; ++j) estado[j] = t[j];
+	}
+};
+
+typedef XoshiroSoA<4> Xoshiro256x4;
+typedef XoshiroSoA<8> Xoshiro256x8;
+typedef XoshiroSoA<16> Xoshiro256x16;
+
+/**
+ * Llena 'n' palabras seguidas con la salida del generador. Es la misma secuencia
+ * que llamar n veces a gen(), pero los generadores vectoriales escriben vectores
+ * completos directamente en el búfer.
+ */
+template <class Motor, class Palabra>
+inline void rellenar_palabras(Motor& gen, Palabra* palabras, long long n) {
+	for (long long k = 0; k < n; ++k) {
+		palabras[k] = static_cast<Palabra>(gen());
+	}
+}
+
+template <int L>
+inline void rellenar_palabras(XoshiroSoA<L>& gen, uint64_t* palabras, long long n) {
+	long long k = 0;
+	for (; k < n && gen.palabras_pendientes() > 0; ++k) {
+		palabras[k] = gen();
+	}
+	for (; k + L <= n; k += L) {
+		gen.siguiente_vector(palabras + k);
+	}
+	for (; k < n; ++k) {
+		palabras[k] = gen();
+	}
+}
+
+/**
+ * AES-128 EN MODO CONTADOR (AES-CTR)
+ *
+ * Cada palabra de 128 bits de salida es AES_k(contador): la clave sale de la
+ * siembra (seed_seq) y el contador avanza de uno en uno. Hereda la calidad de un
+ * cifrador por bloques, y como cualquier posición de la secuencia se calcula
+ * directamente a partir de su contador, discard(n) es inmediato.
+ *
+ * Con AES-NI cada ronda es una instrucción (aesenc) y se cifran 4 contadores a
+ * la vez para solapar la latencia de las rondas. Si el procesador no tiene AES-NI
+ * (o no es x86) se usa una implementación por software de AES, más lenta pero
+ * con la misma salida bit a bit, así que los resultados no dependen de la máquina.
+ */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define GENERADORES_AES_X86
+#include <wmmintrin.h>  // _mm_aesenc_si128
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define OBJETIVO_AES
+#else
+#include <cpuid.h>
+#define OBJETIVO_AES __attribute__((target("aes,sse2")))
+#endif
+#endif
+
+// true si el procesador tiene instrucciones AES-NI (CPUID.1:ECX bit 25)
+inline bool aes_ni_disponible() {
+#if defined(GENERADORES_AES_X86) && defined(_MSC_VER)
+	int registros[4];
+	__cpuid(registros, 1);
+	return (registros[2] >> 25) & 1;
+#elif defined(GENERADORES_AES_X86)
+	unsigned int a, b, c, d;
+	return __get_cpuid(1, &a, &b, &c, &d) && ((c >> 25) & 1);
+#else
+	return false;
+#endif
+}
+
+// Tablas de AES por software: S-box calculada como inverso en GF(2^8) más la
+// transformación afín, en lugar de escribir sus 256 valores
+struct TablasAes {
+	uint8_t sbox[256];
+
+	TablasAes() {
+		for (int x = 0; x < 256; ++x) {
+			// Inverso multiplicativo: x^254 (0 se queda en 0)
+			uint8_t inverso = 1, base = (uint8_t)x;
+			for (int e = 254; e > 0; e >>= 1) {
+				if (e & 1) inverso = multiplicar(inverso, base);
+				base = multiplicar(base, base);
+			}
+			if (x == 0) inverso = 0;
+			uint8_t s = inverso;
+			for (int r = 1; r <= 4; ++r) {
+				s ^= (uint8_t)((inverso << r) | (inverso >> (8 - r)));
+			}
+			sbox[x] = s ^ 0x63;
+		}
+	}
+
+	static uint8_t multiplicar(uint8_t a, uint8_t b) {
+		uint8_t p = 0;
+		for (int i = 0; i < 8; ++i) {
+			if (b & 1) p ^= a;
+			a = (uint8_t)((a << 1) ^ ((a & 0x80) ? 0x1b : 0));
+			b >>= 1;
+		}
+		return p;
+	}
+
+	static const TablasAes& instancia() {
+		static const TablasAes tablas;  // Inicialización segura entre hilos (C++11)
+		return tablas;
+	}
+};
+
+#if defined(GENERADORES_AES_X86)
+// Cifra los contadores [contador, contador + 4) con AES-NI
+OBJETIVO_AES inline void cifrar_aes_ni(const uint8_t* claves, uint64_t contador, uint64_t* salida) {
+	__m128i k[11];
+	for (int i = 0; i < 11; ++i) {
+		k[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(claves + 16 * i));
+	}
+	__m128i b0 = _mm_xor_si128(_mm_set_epi64x(0, (long long)contador), k[0]);
+	__m128i b1 = _mm_xor_si128(_mm_set_epi64x(0, (long long)(contador + 1)), k[0]);
+	__m128i b2 = _mm_xor_si128(_mm_set_epi64x(0, (long long)(contador + 2)), k[0]);
+	__m128i b3 = _mm_xor_si128(_mm_set_epi64x(0, (long long)(contador + 3)), k[0]);
+	for (int r = 1; r < 10; ++r) {
+		b0 = _mm_aesenc_si128(b0, k[r]);
+		b1 = _mm_aesenc_si128(b1, k[r]);
+		b2 = _mm_aesenc_si128(b2, k[r]);
+		b3 = _mm_aesenc_si128(b3, k[r]);
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(salida), _mm_aesenclast_si128(b0, k[10]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(salida + 2), _mm_aesenclast_si128(b1, k[10]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(salida + 4), _mm_aesenclast_si128(b2, k[10]));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(salida + 6), _mm_aesenclast_si128(b3, k[10]));
+}
+#endif
+
+class AesCtr {
+public:
+	typedef uint64_t result_type;
+	static const int PALABRAS_POR_LOTE = 8;  // 4 bloques de 128 bits
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~(uint64_t)0; }
+
+	AesCtr() {
+		std::seed_seq secuencia{ 0u };
+		seed(secuencia);
+	}
+
+	void seed(std::seed_seq& secuencia) {
+		uint32_t palabras[4];
+		secuencia.generate(palabras, palabras + 4);
+		uint8_t clave[16];
+		for (int i = 0; i < 16; ++i) {
+			clave[i] = (uint8_t)(palabras[i / 4] >> (8 * (i % 4)));
+		}
+		expandir_clave(clave);
+		contador = 0;
+		pendientes = 0;
+		static const bool hardware = aes_ni_disponible();
+		usar_aes_ni = hardware;
+	}
+
+	// Cifra los 4 contadores siguientes: 8 palabras de 64 bits
+	void siguiente_lote(uint64_t* destino) {
+#if defined(GENERADORES_AES_X86)
+		if (usar_aes_ni) {
+			cifrar_aes_ni(claves, contador, destino);
+			contador += 4;
+			return;
+		}
+#endif
+		for (int j = 0; j < 4; ++j) {
+			cifrar_software(contador++, destino + 2 * j);
+		}
+	}
+
+	result_type operator()() {
+		if (pendientes == 0) {
+			siguiente_lote(salida);
+			pendientes = PALABRAS_POR_LOTE;
+		}
+		return salida[PALABRAS_POR_LOTE - pendientes--];
+	}
+
+	// Salto directo: solo se generan las palabras sueltas de los extremos
+	void discard(unsigned long long n) {
+		for (; n > 0 && pendientes > 0; --n) {
+			(*this)();
+		}
+		contador += (n / PALABRAS_POR_LOTE) * 4;
+		for (n %= PALABRAS_POR_LOTE; n > 0; --n) {
+			(*this)();
+		}
+	}
+
+	int palabras_pendientes() const { return pendientes; }
+	bool con_aes_ni() const { return usar_aes_ni; }
+
+	// Fuerza la implementación por software (para comprobar que coinciden)
+	void desactivar_aes_ni() { usar_aes_ni = false; }
+
+private:
+	uint8_t claves[11 * 16];   // Claves de ronda, en el orden de bytes de FIPS-197
+	uint64_t contador;
+	uint64_t salida[PALABRAS_POR_LOTE];
+	int pendientes;
+	bool usar_aes_ni;
+
+	void expandir_clave(const uint8_t* clave) {
+		const uint8_t* sbox = TablasAes::instancia().sbox;
+		uint8_t rcon = 1;
+		for (int i = 0; i < 16; ++i) claves[i] = clave[i];
+		for (int i = 16; i < 176; i += 4) {
+			uint8_t t[4] = { claves[i - 4], claves[i - 3], claves[i - 2], claves[i - 1] };
+			if (i % 16 == 0) {
+				uint8_t primero = t[0];
+				t[0] = sbox[t[1]] ^ rcon;
+				t[1] = sbox[t[2]];
+				t[2] = sbox[t[3]];
+				t[3] = sbox[primero];
+				rcon = TablasAes::multiplicar(rcon, 2);
+			}
+			for (int j = 0; j < 4; ++j) claves[i + j] = claves[i - 16 + j] ^ t[j];
+		}
+	}
+
+	// AES-128 por software de un contador (bloque de 16 bytes en little-endian)
+	void cifrar_software(uint64_t valor, uint64_t* salida_bloque) const {
+		const uint8_t* sbox = TablasAes::instancia().sbox;
+		uint8_t e[16];
+		for (int i = 0; i < 16; ++i) {
+			e[i] = (uint8_t)(i < 8 ? valor >> (8 * i) : 0) ^ claves[i];
+		}
+		for (int ronda = 1; ronda <= 10; ++ronda) {
+			// SubBytes y ShiftRows (el byte i es la fila i % 4 de la columna i / 4)
+			uint8_t t[16];
+			for (int i = 0; i < 16; ++i) {
+				int fila = i % 4, columna = i / 4;
+				t[i] = sbox[e[fila + 4 * ((columna + fila) % 4)]];
+			}
+			// MixColumns (salvo en la última ronda) y AddRoundKey
+			for (int c = 0; c < 4; ++c) {
+				uint8_t* col = t + 4 * c;
+				if (ronda < 10) {
+					uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+					uint8_t todos = a0 ^ a1 ^ a2 ^ a3;
+					col[0] ^= todos ^ TablasAes::multiplicar(a0 ^ a1, 2);
+					col[1] ^= todos ^ TablasAes::multiplicar(a1 ^ a2, 2);
+					col[2] ^= todos ^ TablasAes::multiplicar(a2 ^ a3, 2);
+					col[3] ^= todos ^ TablasAes::multiplicar(a3 ^ a0, 2);
+				}
+			}
+			for (int i = 0; i < 16; ++i) e[i] = t[i] ^ claves[16 * ronda + i];
+		}
+		salida_bloque[0] = salida_bloque[1] = 0;
+		for (int i = 0; i < 16; ++i) {
+			salida_bloque[i / 8] |= (uint64_t)e[i] << (8 * (i % 8));
+		}
+	}
+};
+
+inline void rellenar_palabras(AesCtr& gen, uint64_t* palabras, long long n) {
+	long long k = 0;
+	for (; k < n && gen.palabras_pendientes() > 0; ++k) {
+		palabras[k] = gen();
+	}
+	for (; k + AesCtr::PALABRAS_POR_LOTE <= n; k += AesCtr::PALABRAS_POR_LOTE) {
+		gen.siguiente_lote(palabras + k);
+	}
+	for (; k < n; ++k) {
+		palabras[k] = gen();
+	}
+}
+
+/**
+ * GENERADORES PARA EL BENCHMARK
+ *
+ * PCG32, Philox4x32-10 y RDRAND se usan solo en el benchmark de generadores
+ * (no están en la tabla de núcleos), como referencia de otras familias: un LCG
+ * con permutación de salida, un generador basado en contador sin tablas ni
+ * instrucciones especiales y el generador por hardware del procesador.
+ */
+
+// PCG32 (XSH RR): estado de 64 bits, salida de 32
+class Pcg32 {
+public:
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	Pcg32() {
+		std::seed_seq secuencia{ 0u };
+		seed(secuencia);
+	}
+
+	void seed(std::seed_seq& secuencia) {
+		uint32_t palabras[4];
+		secuencia.generate(palabras, palabras + 4);
+		incremento = (((uint64_t)palabras[2] << 32) | palabras[3]) | 1;  // Debe ser impar
+		estado = 0;
+		(*this)();
+		estado += ((uint64_t)palabras[0] << 32) | palabras[1];
+		(*this)();
+	}
+
+	result_type operator()() {
+		uint64_t anterior = estado;
+		estado = anterior * 6364136223846793005ULL + incremento;
+		uint32_t mezcla = (uint32_t)(((anterior >> 18) ^ anterior) >> 27);
+		uint32_t rotacion = (uint32_t)(anterior >> 59);
+		return (mezcla >> rotacion) | (mezcla << ((0u - rotacion) & 31));
+	}
+
+	void discard(unsigned long long n) {
+		for (; n > 0; --n) (*this)();
+	}
+
+private:
+	uint64_t estado;
+	uint64_t incremento;
+};
+
+// Philox4x32-10: 10 rondas de multiplicaciones sobre un contador de 128 bits,
+// 4 salidas de 32 bits por contador
+class Philox4x32 {
+public:
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	Philox4x32() {
+		std::seed_seq secuencia{ 0u };
+		seed(secuencia);
+	}
+
+	void seed(std::seed_seq& secuencia) {
+		secuencia.generate(clave, clave + 2);
+		contador = 0;
+		pendientes = 0;
+	}
+
+	// Cifra el contador indicado con la clave dada (expuesto para comprobar el vector de prueba)
+	static void cifrar(const uint32_t* entrada, const uint32_t* clave_inicial, uint32_t* salida) {
+		uint32_t c[4] = { entrada[0], entrada[1], entrada[2], entrada[3] };
+		uint32_t k[2] = { clave_inicial[0], clave_inicial[1] };
+		for (int ronda = 0; ronda < 10; ++ronda) {
+			uint64_t p0 = (uint64_t)0xD2511F53u * c[0];
+			uint64_t p1 = (uint64_t)0xCD9E8D57u * c[2];
+			uint32_t nuevo[4] = {
+				(uint32_t)(p1 >> 32) ^ c[1] ^ k[0], (uint32_t)p1,
+				(uint32_t)(p0 >> 32) ^ c[3] ^ k[1], (uint32_t)p0 };
+			for (int i = 0; i < 4; ++i) c[i] = nuevo[i];
+			k[0] += 0x9E3779B9u;
+			k[1] += 0xBB67AE85u;
+		}
+		for (int i = 0; i < 4; ++i) salida[i] = c[i];
+	}
+
+	result_type operator()() {
+		if (pendientes == 0) {
+			uint32_t entrada[4] = { (uint32_t)contador, (uint32_t)(contador >> 32), 0, 0 };
+			cifrar(entrada, clave, salida);
+			++contador;
+			pendientes = 4;
+		}
+		return salida[4 - pendientes--];
+	}
+
+	void discard(unsigned long long n) {
+		for (; n > 0 && pendientes > 0; --n) (*this)();
+		contador += n / 4;
+		for (n %= 4; n > 0; --n) (*this)();
+	}
+
+private:
+	uint32_t clave[2];
+	uint64_t contador;
+	uint32_t salida[4];
+	int pendientes;
+};
+
+// RDRAND: aleatoriedad por hardware. No es reproducible (se ignora la siembra)
+#if defined(GENERADORES_AES_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define OBJETIVO_RDRAND
+#else
+#define OBJETIVO_RDRAND __attribute__((target("rdrnd")))
+#endif
+
+// true si el procesador tiene RDRAND (CPUID.1:ECX bit 30)
+inline bool rdrand_disponible() {
+#if defined(_MSC_VER)
+	int registros[4];
+	__cpuid(registros, 1);
+	return (registros[2] >> 30) & 1;
+#else
+	unsigned int a, b, c, d;
+	return __get_cpuid(1, &a, &b, &c, &d) && ((c >> 30) & 1);
+#endif
+}
+
+class RdRand {
+public:
+	typedef uint64_t result_type;
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~(uint64_t)0; }
+
+	void seed(std::seed_seq&) {}
+
+	// RDRAND puede fallar momentáneamente si se agota su entropía: se reintenta
+	OBJETIVO_RDRAND result_type operator()() {
+#if defined(_M_IX86) || defined(__i386__)
+		unsigned int alto, bajo;
+		while (!_rdrand32_step(&alto)) {}
+		while (!_rdrand32_step(&bajo)) {}
+		return ((uint64_t)alto << 32) | bajo;
+#else
+		unsigned long long valor;
+		while (!_rdrand64_step(&valor)) {}
+		return valor;
+#endif
+	}
+};
+#else
+inline bool rdrand_disponible() { return false; }
+#endif
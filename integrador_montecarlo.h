@@ -0,0 +1,228 @@
+/******************************************************************************
+ * INTEGRADOR DE MONTE CARLO GENÉRICO
+ *****************************************************************************
+ *
+ * integrar(f, dominio, samples, politica) estima la integral de f sobre una caja
+ * de D dimensiones con el mismo esquema que el motor paralelo del programa:
+ *   - Las muestras se agrupan en bloques de MUESTRAS_POR_BLOQUE, y el generador
+ *     de cada bloque se siembra con (semilla, bloque)
+ *   - Las palabras del generador se piden por lotes (rellenar_palabras) y se
+ *     convierten a double con la resolución completa
+ *   - Los bloques se reparten entre hilos con schedule(dynamic), y sus sumas se
+ *     combinan en orden de bloque, así que el resultado es idéntico con
+ *     cualquier número de hilos
+ *
+ * Ese reparto y esa combinación están en sumar_por_bloques y combinar_bloques,
+ * que también usan la valoración de opciones y los modos del programa con sumas
+ * por bloque: cada uno solo aporta cómo se suma un bloque.
+ *
+ * El integrando puede ser:
+ *   - Escalar:  double f(const double* x)          (x con D coordenadas)
+ *   - Por lotes: void f(const double* puntos, int n, double* valores)
+ *                (n puntos seguidos de D coordenadas cada uno; permite SIMD)
+ * Se detecta la forma al compilar, y la llamada se puede expandir en línea al
+ * ser f un parámetro de plantilla. Cada hilo trabaja con su propia copia de f.
+ *
+ * Ejemplo:
+ *   Dominio<2> cuadrado = { { 0.0, 0.0 }, { 1.0, 1.0 } };
+ *   ResultadoIntegral r = integrar(
+ *       [](const double* x) { return x[0] * x[0] + x[1] * x[1] <= 1.0 ? 4.0 : 0.0; },
+ *       cuadrado, 1000000, PoliticaIntegracion());
+ *   // r.valor ~ π, r.error_estandar ~ 1,6e-3
+ */
+
+#pragma once
+
+#include <vector>
+#include <type_traits>
+#include <utility>
+#include <math.h>
+#include <omp.h>
+#include "nucleos_montecarlo.h"  // Bloques, siembra, conversión de palabras y generadores
+
+// Caja de integración [inferior, superior] en D dimensiones
+template <int D>
+struct Dominio {
+	double inferior[D];
+	double superior[D];
+
+	double volumen() const {
+		double v = 1.0;
+		for (int d = 0; d < D; ++d) {
+			v *= superior[d] - inferior[d];
+		}
+		return v;
+	}
+};
+
+// Cómo se reparte el trabajo (el generador se elige como parámetro de plantilla)
+struct PoliticaIntegracion {
+	int num_hilos = 8;
+	int bloques_por_chunk = 1;       // Bloques que toma un hilo de cada vez
+	unsigned long long semilla = 0;  // Semilla base: misma semilla, mismo resultado
+};
+
+struct ResultadoIntegral {
+	double valor;            // Estimación de la integral
+	double error_estandar;   // Desviación típica de la estimación
+	long long samples;
+	double suma;             // Suma de f en todos los puntos
+	double tiempo_segundos;
+};
+
+// Suma de los valores y de sus cuadrados (de un bloque, o de varios combinados)
+struct SumasBloque {
+	double suma = 0.0;
+	double suma_cuadrados = 0.0;
+
+	SumasBloque& operator+=(const SumasBloque& otras) {
+		suma += otras.suma;
+		suma_cuadrados += otras.suma_cuadrados;
+		return *this;
+	}
+};
+
+// Muestras del bloque b cuando hay 'samples' en total (el último puede ir incompleto)
+inline long long muestras_bloque(long long samples, long long b) {
+	long long n = samples - b * MUESTRAS_POR_BLOQUE;
+	return n > MUESTRAS_POR_BLOQUE ? MUESTRAS_POR_BLOQUE : n;
+}
+
+/**
+ * Reparte los bloques entre los hilos con schedule(dynamic) y guarda las sumas
+ * de cada uno en su posición
+ *
+ * @tparam Sumas: Lo que se acumula por bloque (con += para combinar bloques)
+ * @param bloques: Número de bloques
+ * @param politica: Hilos y bloques por chunk
+ * @param sumar: sumar(b, sumas) deja en 'sumas' las del bloque b. Cada hilo trabaja
+ *               con su propia copia, así que puede guardar estado mutable
+ * @return Sumas de cada bloque, en orden de bloque
+ */
+template <class Sumas, class F>
+std::vector<Sumas> sumar_por_bloques(long long bloques, const PoliticaIntegracion& politica, F sumar) {
+	std::vector<Sumas> por_bloque(bloques);
+	long long b;
+#pragma omp parallel for schedule(dynamic, politica.bloques_por_chunk) firstprivate(sumar) num_threads(politica.num_hilos)
+	for (b = 0; b < bloques; ++b) {
+		sumar(b, por_bloque[b]);
+	}
+	return por_bloque;
+}
+
+/**
+ * Combina en orden de bloque las sumas de los bloques [desde, hasta): el total
+ * no depende de qué hilo hizo cada bloque
+ */
+template <class Sumas>
+Sumas combinar_bloques(const std::vector<Sumas>& por_bloque, long long desde, long long hasta) {
+	Sumas total = {};
+	for (long long b = desde; b < hasta; ++b) {
+		total += por_bloque[b];
+	}
+	return total;
+}
+
+/**
+ * Valor (escala·media), error estándar y suma a partir de las sumas de todas
+ * las muestras
+ */
+inline ResultadoIntegral resultado_de_sumas(const SumasBloque& total, long long samples, double escala,
+	double tiempo_segundos) {
+	ResultadoIntegral resultado;
+	double media = samples > 0 ? total.suma / samples : 0.0;
+	double varianza = samples > 1 ? (total.suma_cuadrados - total.suma * media) / (samples - 1) : 0.0;
+	if (varianza < 0.0) varianza = 0.0;
+	resultado.valor = escala * media;
+	resultado.error_estandar = samples > 0 ? escala * sqrt(varianza / samples) : 0.0;
+	resultado.samples = samples;
+	resultado.suma = total.suma;
+	resultado.tiempo_segundos = tiempo_segundos;
+	return resultado;
+}
+
+// Puntos que se generan y evalúan de cada vez dentro de un bloque
+const int PUNTOS_LOTE_INTEGRAL = 128;
+
+// Detecta si F admite la forma por lotes f(puntos, n, valores)
+template <class F, class = void>
+struct EsIntegrandoPorLotes : std::false_type {};
+template <class F>
+struct EsIntegrandoPorLotes<F, std::void_t<decltype(std::declval<F&>()(
+	std::declval<const double*>(), 0, std::declval<double*>()))> > : std::true_type {};
+
+/**
+ * Suma f y f² en las n primeras muestras de un bloque
+ */
+template <class Motor, int D, class F>
+inline void integrar_bloque(F& f, const Dominio<D>& dominio, unsigned long long semilla,
+	long long bloque, long long n, double& suma, double& suma_cuadrados) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	typedef ConversionPalabras<Palabra, double> Conversion;
+	const int palabras_punto = D * Conversion::palabras;
+
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+
+	Palabra palabras[PUNTOS_LOTE_INTEGRAL * palabras_punto];
+	double puntos[PUNTOS_LOTE_INTEGRAL * D];
+	double valores[PUNTOS_LOTE_INTEGRAL];
+	double ancho[D];
+	for (int d = 0; d < D; ++d) {
+		ancho[d] = dominio.superior[d] - dominio.inferior[d];
+	}
+
+	suma = 0.0;
+	suma_cuadrados = 0.0;
+	for (long long hecho = 0; hecho < n; ) {
+		int lote = n - hecho < PUNTOS_LOTE_INTEGRAL ? (int)(n - hecho) : PUNTOS_LOTE_INTEGRAL;
+		rellenar_palabras(gen, palabras, (long long)lote * palabras_punto);
+		for (int k = 0; k < lote; ++k) {
+			for (int d = 0; d < D; ++d) {
+				double u = Conversion::convertir(palabras + (k * D + d) * Conversion::palabras);
+				puntos[k * D + d] = dominio.inferior[d] + ancho[d] * u;
+			}
+		}
+
+		if constexpr (EsIntegrandoPorLotes<F>::value) {
+			f((const double*)puntos, lote, valores);
+		}
+		else {
+			for (int k = 0; k < lote; ++k) {
+				valores[k] = f((const double*)(puntos + k * D));
+			}
+		}
+
+		for (int k = 0; k < lote; ++k) {
+			suma += valores[k];
+			suma_cuadrados += valores[k] * valores[k];
+		}
+		hecho += lote;
+	}
+}
+
+/**
+ * Estima la integral de f sobre el dominio
+ *
+ * @tparam Motor: Generador (std::mt19937 por defecto, o cualquiera de generadores.h)
+ * @param f: Integrando, escalar o por lotes
+ * @param dominio: Caja de integración
+ * @param samples: Número de puntos
+ * @param politica: Hilos, reparto y semilla
+ * @return Valor, error estándar, suma y tiempo
+ */
+template <class Motor = std::mt19937, int D, class F>
+ResultadoIntegral integrar(F f, const Dominio<D>& dominio, long long samples,
+	const PoliticaIntegracion& politica) {
+	long long bloques = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	unsigned long long semilla = politica.semilla;
+
+	double inicio = omp_get_wtime();
+	std::vector<SumasBloque> por_bloque = sumar_por_bloques<SumasBloque>(bloques, politica,
+		[f, &dominio, semilla, samples](long long b, SumasBloque& s) mutable {
+			integrar_bloque<Motor, D>(f, dominio, semilla, b, muestras_bloque(samples, b),
+				s.suma, s.suma_cuadrados);
+		});
+	SumasBloque total = combinar_bloques(por_bloque, 0, bloques);
+	return resultado_de_sumas(total, samples, dominio.volumen(), omp_get_wtime() - inicio);
+}
@@ -0,0 +1,232 @@
+/******************************************************************************
+ * GENERACIÓN DE NORMALES POR LOTES
+ *****************************************************************************
+ *
+ * Normales estándar a partir de las palabras de cualquier generador del
+ * programa, pidiéndolas por lotes con rellenar_palabras, como el resto de la
+ * tubería con búfer. Dos métodos:
+ *
+ *   - Box-Muller: cada par de uniformes da dos normales. Se calcula en dos
+ *     bucles sin saltos (radio y ángulo; después coseno y seno), que el
+ *     compilador puede vectorizar con sus funciones matemáticas vectoriales
+ *     (MSVC con /O2; GCC con -O3 -ffast-math y la libmvec de glibc)
+ *
+ *   - Ziggurat (Marsaglia-Tsang, con 256 capas como el ZIGNOR de Doornik): cada
+ *     palabra de 64 bits da una capa (8 bits bajos) y una abscisa con signo
+ *     (53 bits altos). En el 98,5 % de los casos la abscisa cae dentro del
+ *     rectángulo de su capa y es la normal, sin más cálculos. Ese caso rápido se
+ *     evalúa para todo el lote en un bucle sin saltos; los candidatos que caen
+ *     fuera (la cuña de la capa o la cola más allá de r) se resuelven después,
+ *     en orden y cada uno en su misma posición, con palabras adicionales del
+ *     mismo generador hasta que se acepta uno. Así todas las posiciones del lote
+ *     tienen la misma distribución (no hay posiciones que reciban solo los casos
+ *     lentos, que son los de las colas)
+ *
+ * Con generadores de 32 bits cada uniforme (o candidato del Ziggurat) usa dos
+ * palabras, igual que ConversionPalabras<uint32_t, double>. La secuencia depende
+ * solo del estado del generador, así que la siembra por bloques sigue dando
+ * resultados independientes del número de hilos.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include "nucleos_montecarlo.h"  // PalabraMotor, ConversionPalabras y rellenar_palabras
+
+enum MetodoNormal { NORMAL_BOX_MULLER, NORMAL_ZIGGURAT, NUM_METODOS_NORMAL };
+const char* const NOMBRES_NORMAL[] = { "box-muller", "ziggurat" };
+
+// Normales que se generan de cada vez (los búferes intermedios quedan en la caché L1)
+const int LOTE_NORMALES = 256;
+
+// Capas del Ziggurat: el índice son los 8 bits bajos de la palabra
+const int CAPAS_ZIGGURAT = 256;
+
+/**
+ * Tabla del Ziggurat. x[i] es el borde derecho de la capa i (x[0] es el ancho
+ * equivalente de la capa base con la cola incluida, x[1] = r y x[256] = 0), y
+ * cociente[i] = x[i + 1] / x[i] es el límite del caso rápido.
+ */
+struct TablaZiggurat {
+	double x[CAPAS_ZIGGURAT + 1];
+	double cociente[CAPAS_ZIGGURAT];
+	double r;
+
+	TablaZiggurat() {
+		r = 3.6541528853610088;
+		const double v = 0.00492867323399;  // Área de cada capa
+		double f = exp(-0.5 * r * r);
+		x[0] = v / f;
+		x[1] = r;
+		for (int i = 2; i < CAPAS_ZIGGURAT; ++i) {
+			x[i] = sqrt(-2.0 * log(v / x[i - 1] + f));
+			f = exp(-0.5 * x[i] * x[i]);
+		}
+		x[CAPAS_ZIGGURAT] = 0.0;
+		for (int i = 0; i < CAPAS_ZIGGURAT; ++i) {
+			cociente[i] = x[i + 1] / x[i];
+		}
+	}
+};
+
+// Se calcula una vez (la inicialización de un static local es segura entre hilos)
+inline const TablaZiggurat& tabla_ziggurat() {
+	static const TablaZiggurat tabla;
+	return tabla;
+}
+
+// Candidato de 64 bits: una palabra de 64 bits o dos de 32
+inline uint64_t palabra_64(const uint64_t* p) { return p[0]; }
+inline uint64_t palabra_64(const uint32_t* p) { return ((uint64_t)p[0] << 32) | p[1]; }
+
+// Una uniforme en (0, 1] sacada del generador (para los casos lentos)
+template <class Motor>
+inline double uniforme_abierta(Motor& gen) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	typedef ConversionPalabras<Palabra, double> Conversion;
+	Palabra p[Conversion::palabras];
+	rellenar_palabras(gen, p, Conversion::palabras);
+	return 1.0 - Conversion::convertir(p);
+}
+
+/**
+ * Capa y abscisa del candidato de la palabra w
+ *
+ * @return true si el candidato cae en el caso rápido (dentro del rectángulo de su capa)
+ */
+inline bool ziggurat_candidato(const TablaZiggurat& t, uint64_t w, int& capa, double& x) {
+	capa = (int)(w & (CAPAS_ZIGGURAT - 1));
+	double u = (double)(w >> 11) * (1.0 / 4503599627370496.0) - 1.0;  // [-1, 1)
+	x = u * t.x[capa];
+	return fabs(u) < t.cociente[capa];
+}
+
+/**
+ * Caso lento del Ziggurat para un candidato rechazado por el caso rápido
+ *
+ * @param capa: Capa del candidato
+ * @param x: Abscisa del candidato (u·x[capa], con signo)
+ * @param normal: Normal resultante si se acepta
+ * @return false si el candidato se rechaza (hay que sacar otro)
+ */
+template <class Motor>
+inline bool ziggurat_lento(Motor& gen, const TablaZiggurat& t, int capa, double x, double& normal) {
+	if (capa == 0) {
+		// Cola más allá de r (Marsaglia): exponencial desplazada con rechazo
+		double cola, y;
+		do {
+			cola = -log(uniforme_abierta(gen)) / t.r;
+			y = -log(uniforme_abierta(gen));
+		} while (y + y < cola * cola);
+		normal = x < 0 ? -(t.r + cola) : t.r + cola;
+		return true;
+	}
+	// Cuña: punto uniforme en altura entre las densidades de los dos bordes
+	double f0 = exp(-0.5 * (t.x[capa] * t.x[capa] - x * x));
+	double f1 = exp(-0.5 * (t.x[capa + 1] * t.x[capa + 1] - x * x));
+	if (f1 + uniforme_abierta(gen) * (f0 - f1) < 1.0) {
+		normal = x;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Genera n normales estándar con el Ziggurat
+ */
+template <class Motor>
+inline void generar_normales_ziggurat(Motor& gen, double* normales, int n) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	const int palabras_candidato = sizeof(uint64_t) / sizeof(Palabra);
+	const TablaZiggurat& t = tabla_ziggurat();
+
+	Palabra palabras[LOTE_NORMALES * palabras_candidato];
+	int capas[LOTE_NORMALES];
+	unsigned char rapido[LOTE_NORMALES];
+
+	for (int hechas = 0; hechas < n; ) {
+		int pedir = n - hechas < LOTE_NORMALES ? n - hechas : LOTE_NORMALES;
+		double* lote = normales + hechas;
+		rellenar_palabras(gen, palabras, (long long)pedir * palabras_candidato);
+
+		// Caso rápido para todo el lote, sin saltos
+		for (int k = 0; k < pedir; ++k) {
+			rapido[k] = ziggurat_candidato(t, palabra_64(palabras + k * palabras_candidato), capas[k], lote[k]);
+		}
+
+		// Casos lentos, en orden y en su posición: si se rechaza el candidato se
+		// saca otro (que puede volver a caer en el caso rápido) hasta aceptar
+		for (int k = 0; k < pedir; ++k) {
+			if (rapido[k]) continue;
+			int capa = capas[k];
+			double x = lote[k];
+			while (!ziggurat_lento(gen, t, capa, x, lote[k])) {
+				Palabra candidato[palabras_candidato];
+				rellenar_palabras(gen, candidato, palabras_candidato);
+				if (ziggurat_candidato(t, palabra_64(candidato), capa, x)) {
+					lote[k] = x;
+					break;
+				}
+			}
+		}
+		hechas += pedir;
+	}
+}
+
+/**
+ * Genera n normales estándar con Box-Muller (si n es impar se descarta el
+ * seno del último par)
+ */
+template <class Motor>
+inline void generar_normales_box_muller(Motor& gen, double* normales, int n) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	typedef ConversionPalabras<Palabra, double> Conversion;
+	const double dos_pi = 6.28318530717958647692;
+
+	Palabra palabras[LOTE_NORMALES * Conversion::palabras];
+	double radios[LOTE_NORMALES / 2];
+	double angulos[LOTE_NORMALES / 2];
+	double senos[LOTE_NORMALES / 2];
+
+	for (int hechas = 0; hechas < n; ) {
+		int pares = n - hechas < LOTE_NORMALES ? (n - hechas + 1) / 2 : LOTE_NORMALES / 2;
+		rellenar_palabras(gen, palabras, (long long)2 * pares * Conversion::palabras);
+
+		for (int j = 0; j < pares; ++j) {
+			double u1 = Conversion::convertir(palabras + 2 * j * Conversion::palabras);
+			double u2 = Conversion::convertir(palabras + (2 * j + 1) * Conversion::palabras);
+			radios[j] = sqrt(-2.0 * log(1.0 - u1));  // 1 - u1 en (0, 1]: log finito
+			angulos[j] = dos_pi * u2;
+		}
+		for (int j = 0; j < pares; ++j) {
+			senos[j] = radios[j] * sin(angulos[j]);
+			radios[j] *= cos(angulos[j]);
+		}
+
+		int quedan = n - hechas;
+		int completos = quedan < 2 * pares ? pares - 1 : pares;
+		double* salida = normales + hechas;
+		for (int j = 0; j < completos; ++j) {
+			salida[2 * j] = radios[j];
+			salida[2 * j + 1] = senos[j];
+		}
+		if (completos < pares) {
+			salida[2 * completos] = radios[completos];
+		}
+		hechas += 2 * pares < quedan ? 2 * pares : quedan;
+	}
+}
+
+/**
+ * Genera n normales estándar con el método elegido (MetodoNormal)
+ */
+template <class Motor>
+inline void generar_normales(int metodo, Motor& gen, double* normales, int n) {
+	if (metodo == NORMAL_ZIGGURAT) {
+		generar_normales_ziggurat(gen, normales, n);
+	}
+	else {
+		generar_normales_box_muller(gen, normales, n);
+	}
+}
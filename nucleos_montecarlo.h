@@ -0,0 +1,995 @@
+/******************************************************************************
+ * NÚCLEOS DE MUESTREO DEL MÉTODO DE MONTE CARLO
+ *****************************************************************************
+ *
+ * Un único bucle de muestreo, parametrizado en tiempo de compilación por:
+ *   - Motor:      generador de números aleatorios (std::mt19937, ...)
+ *   - Real:       tipo de las coordenadas (double o float)
+ *   - Estimador:  qué se acumula por cada punto (acierto-fallo, valor medio, ...)
+ *   - U:          puntos generados por iteración (desenrollado)
+ *
+ * Además de este bucle escalar hay variantes con otra organización del trabajo
+ * (la tubería con búfer de sumar_bloque_bufer o los generadores intercalados de
+ * sumar_bloque_ilp); cada variante tiene su propio parámetro de ajuste en la tabla.
+ *
+ * Cada combinación soportada se instancia una vez y se registra en
+ * TABLA_NUCLEOS. El motor paralelo elige la entrada antes de empezar y la
+ * llama una vez por bloque, así que dentro del bucle de muestras todo es
+ * código concreto, sin llamadas indirectas. Añadir una variante consiste en
+ * añadir una línea a la tabla (y, si es un generador o estimador nuevo, su
+ * identificador y su nombre).
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <math.h>
+#include <random>
+#include <stdint.h>
+#include <type_traits>
+#include <limits>
+#include "generadores.h"  // xoshiro256+ vectorial, AES-CTR y llenado de búferes por bloques
+
+// Número de muestras de cada bloque del motor paralelo. Es la unidad de reparto
+// entre hilos y de checkpoint; cambiarlo cambia la secuencia de números generada.
+const long long MUESTRAS_POR_BLOQUE = 16384;
+
+// Identificadores de cada dimensión de la tabla. El generador, la precisión, el
+// estimador y la variante definen la secuencia y el significado de la suma (se
+// guardan en checkpoints y registros); el desenrollado y el tamaño del búfer solo
+// afectan al rendimiento.
+enum Generador { GEN_MT19937, GEN_MT19937_64, GEN_XOSHIRO_X4, GEN_XOSHIRO_X8, GEN_XOSHIRO_X16,
+	GEN_AES_CTR, NUM_GENERADORES };
+enum Precision { PREC_DOUBLE, PREC_FLOAT, NUM_PRECISIONES };
+enum Estimador { EST_ACIERTOS, EST_VALOR_MEDIO, EST_ACIERTOS_TABLA, NUM_ESTIMADORES };
+enum Variante { VAR_ESCALAR, VAR_BUFER, VAR_DIVIDIDO, VAR_ILP, NUM_VARIANTES };
+const char* const NOMBRES_GENERADOR[] = { "mt19937", "mt19937_64", "xoshiro256+x4", "xoshiro256+x8",
+	"xoshiro256+x16", "aes-ctr" };
+const char* const NOMBRES_PRECISION[] = { "double", "float" };
+const char* const NOMBRES_ESTIMADOR[] = { "aciertos", "valor-medio", "aciertos-tabla" };
+const char* const NOMBRES_VARIANTE[] = { "escalar", "bufer", "dividido-64", "ilp" };
+const int DESENROLLADOS[] = { 1, 2, 4 };  // Muestras por iteración del bucle escalar
+const int NUM_DESENROLLADOS = 3;
+const int TAMANOS_BUFER[] = { 256, 1024, 4096 };  // Palabras del búfer de las variantes con búfer
+const int NUM_TAMANOS_BUFER = 3;
+const int FLUJOS_ILP[] = { 2, 4, 8 };  // Generadores intercalados de la variante ilp
+const int NUM_FLUJOS_ILP = 3;
+
+// Identificador de cada tipo de generador y de precisión en la tabla
+template <class Motor> struct IdGenerador;
+template <> struct IdGenerador<std::mt19937> { static const int id = GEN_MT19937; };
+template <> struct IdGenerador<std::mt19937_64> { static const int id = GEN_MT19937_64; };
+template <> struct IdGenerador<Xoshiro256x4> { static const int id = GEN_XOSHIRO_X4; };
+template <> struct IdGenerador<Xoshiro256x8> { static const int id = GEN_XOSHIRO_X8; };
+template <> struct IdGenerador<Xoshiro256x16> { static const int id = GEN_XOSHIRO_X16; };
+template <> struct IdGenerador<AesCtr> { static const int id = GEN_AES_CTR; };
+template <class Real> struct IdPrecision;
+template <> struct IdPrecision<double> { static const int id = PREC_DOUBLE; };
+template <> struct IdPrecision<float> { static const int id = PREC_FLOAT; };
+
+/**
+ * Generador basado en rand() de C, usado por la versión secuencial original.
+ * Su estado es global, así que no se registra en la tabla (no admite bloques
+ * independientes ni uso desde varios hilos).
+ */
+struct MotorRand {
+	int operator()() { return rand(); }
+};
+
+/**
+ * Conversión de la salida del generador a un real uniforme en [0, 1)
+ */
+template <class Motor, class Real>
+struct Uniforme {
+	std::uniform_real_distribution<Real> dis{ Real(0), Real(1) };
+	Real operator()(Motor& gen) { return dis(gen); }
+};
+
+// Con rand() se conserva la conversión original rand()/RAND_MAX, en [0, 1]
+template <class Real>
+struct Uniforme<MotorRand, Real> {
+	Real operator()(MotorRand& gen) { return Real(gen()) / Real(RAND_MAX); }
+};
+
+/**
+ * ESTIMADORES
+ *
+ * Cada estimador define:
+ *   - Acumulador: tipo de la suma dentro de un bloque (entero si es exacta)
+ *   - valor(x, y): contribución de un punto
+ *   - a_pi(suma, n): estimación de π a partir de la suma de n puntos
+ *   - error_estandar(pi, n): desviación típica de esa estimación con n puntos
+ */
+
+// Acierto-fallo: fracción de puntos dentro del cuarto de círculo, que tiende a π/4
+struct EstimadorAciertos {
+	static const int id = EST_ACIERTOS;
+	typedef unsigned long long Acumulador;
+
+	template <class Real>
+	static Acumulador valor(Real x, Real y) {
+		return x * x + y * y <= Real(1);
+	}
+	static double a_pi(double suma, long long n) { return 4.0 * suma / n; }
+	// Binomial: cada punto acierta con probabilidad p = π/4
+	static double error_estandar(double pi, long long n) {
+		double p = pi / 4.0;
+		return 4.0 * sqrt(p * (1.0 - p) / n);
+	}
+};
+
+// Valor medio: E[sqrt(1 - x²)] = π/4 para x uniforme en [0, 1]. Cada punto
+// aporta dos muestras (x e y), promediadas
+struct EstimadorValorMedio {
+	static const int id = EST_VALOR_MEDIO;
+	typedef double Acumulador;
+
+	template <class Real>
+	static Acumulador valor(Real x, Real y) {
+		return 0.5 * (sqrt(1.0 - (double)x * x) + sqrt(1.0 - (double)y * y));
+	}
+	static double a_pi(double suma, long long n) { return 4.0 * suma / n; }
+	// Var[sqrt(1 - x²)] = 2/3 - (π/4)², y el promedio de dos muestras la reduce a la mitad
+	static double error_estandar(double pi, long long n) {
+		double p = pi / 4.0;
+		return 4.0 * sqrt(0.5 * (2.0 / 3.0 - p * p) / n);
+	}
+};
+
+/**
+ * REJILLA DEL CUARTO DE CÍRCULO
+ *
+ * Divide [0, 1]² en N x N celdas (N = 2^BITS_TABLA_CUADRANTE) y clasifica cada
+ * una como interior (todos sus puntos dentro del círculo), exterior (todos
+ * fuera) o frontera. Los bits altos de cada coordenada dan la celda, y solo en
+ * las celdas de frontera (unas 2N de N², menos del 2% con N = 128) hace falta
+ * calcular x² + y². Con un byte por celda la tabla ocupa (N+1)² bytes: 16 KB con
+ * el valor por defecto, para que quepa en la caché L1; se ajusta al compilar
+ * con -DBITS_TABLA_CUADRANTE=B.
+ *
+ * La clasificación deja un margen de 1/N² con el círculo (comparaciones
+ * estrictas en enteros), mucho mayor que el error de redondeo de x² + y², así
+ * que el número de aciertos es exactamente el de EstimadorAciertos.
+ */
+#ifndef BITS_TABLA_CUADRANTE
+#define BITS_TABLA_CUADRANTE 7
+#endif
+
+struct TablaCuadrante {
+	static const int N = 1 << BITS_TABLA_CUADRANTE;
+	static const int LADO = N + 1;         // Una fila y columna más: admite coordenadas iguales a 1
+	enum Celda { EXTERIOR = 0, INTERIOR = 1, FRONTERA = 2 };
+	unsigned char celdas[LADO * LADO];
+
+	TablaCuadrante() {
+		const long long n2 = (long long)N * N;
+		for (long long i = 0; i < LADO; ++i) {
+			for (long long j = 0; j < LADO; ++j) {
+				// Celda [i/N, (i+1)/N) x [j/N, (j+1)/N): esquina más lejana y más cercana
+				unsigned char c = FRONTERA;
+				if ((i + 1) * (i + 1) + (j + 1) * (j + 1) < n2) c = INTERIOR;
+				else if (i * i + j * j > n2) c = EXTERIOR;
+				celdas[i * LADO + j] = c;
+			}
+		}
+	}
+};
+static const TablaCuadrante TABLA_CUADRANTE;
+
+// Acierto-fallo resuelto con la rejilla: una lectura de la tabla por punto salvo en la frontera
+struct EstimadorAciertosTabla {
+	static const int id = EST_ACIERTOS_TABLA;
+	typedef unsigned long long Acumulador;
+
+	template <class Real>
+	static Acumulador valor(Real x, Real y) {
+		int i = (int)(x * Real(TablaCuadrante::N));
+		int j = (int)(y * Real(TablaCuadrante::N));
+		unsigned char c = TABLA_CUADRANTE.celdas[i * TablaCuadrante::LADO + j];
+		if (c != TablaCuadrante::FRONTERA) {
+			return c;
+		}
+		return x * x + y * y <= Real(1);
+	}
+	static double a_pi(double suma, long long n) { return 4.0 * suma / n; }
+	static double error_estandar(double pi, long long n) { return EstimadorAciertos::error_estandar(pi, n); }
+};
+
+/**
+ * Siembra el generador de un bloque a partir de (semilla, bloque)
+ *
+ * std::seed_seq mezcla los 128 bits de (semilla, bloque) y rellena todo el
+ * estado del generador, evitando que bloques distintos compartan secuencia.
+ */
+template <class Motor>
+inline void sembrar_bloque(Motor& gen, unsigned long long semilla, long long bloque) {
+	std::seed_seq secuencia{
+		static_cast<unsigned int>(semilla), static_cast<unsigned int>(semilla >> 32),
+		static_cast<unsigned int>(bloque), static_cast<unsigned int>(bloque >> 32) };
+	gen.seed(secuencia);
+}
+
+/**
+ * BUCLE DE MUESTREO: suma las contribuciones de las siguientes n muestras del generador
+ *
+ * Con U > 1 se generan U puntos por iteración y se acumulan en U sumas
+ * independientes. Los puntos se siguen generando en el mismo orden (x0, y0,
+ * x1, y1, ...), así que con acumuladores enteros el resultado no depende de U.
+ */
+template <class Motor, class Real, class Est, int U>
+inline typename Est::Acumulador sumar_muestras(Motor& gen, long long n) {
+	typename Est::Acumulador suma[U] = {};
+	Real x[U], y[U];
+	Uniforme<Motor, Real> uniforme;
+
+	long long i = 0;
+	for (; i + U <= n; i += U) {
+		for (int k = 0; k < U; ++k) {
+			x[k] = uniforme(gen);
+			y[k] = uniforme(gen);
+		}
+		for (int k = 0; k < U; ++k) {
+			suma[k] += Est::valor(x[k], y[k]);
+		}
+	}
+	for (; i < n; ++i) {
+		x[0] = uniforme(gen);
+		y[0] = uniforme(gen);
+		suma[0] += Est::valor(x[0], y[0]);
+	}
+
+	typename Est::Acumulador total = 0;
+	for (int k = 0; k < U; ++k) {
+		total += suma[k];
+	}
+	return total;
+}
+
+/**
+ * Suma las contribuciones de las muestras [desde, hasta) de un bloque
+ *
+ * El generador del bloque se siembra con (semilla, bloque), por lo que cualquier
+ * muestra puede regenerarse sin depender de qué hilo procesó los bloques anteriores.
+ *
+ * @param semilla: Semilla base de la ejecución
+ * @param bloque: Índice del bloque (la muestra i pertenece al bloque i / MUESTRAS_POR_BLOQUE)
+ * @param desde, hasta: Rango de muestras, contenido dentro del bloque
+ * @return Suma de las contribuciones (número de aciertos en acierto-fallo)
+ */
+template <class Motor, class Real, class Est, int U>
+double sumar_bloque(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+
+	// Avanzar el generador hasta la primera muestra pedida (solo ocurre si el
+	// rango empieza a mitad de bloque)
+	long long saltar = desde - bloque * MUESTRAS_POR_BLOQUE;
+	if (saltar > 0) {
+		sumar_muestras<Motor, Real, Est, 1>(gen, saltar);
+	}
+
+	return (double)sumar_muestras<Motor, Real, Est, U>(gen, hasta - desde);
+}
+
+/**
+ * TUBERÍA CON BÚFER
+ *
+ * En el bucle escalar cada coordenada llama al generador, así que la
+ * actualización de su estado se intercala con la comprobación geométrica y
+ * ninguna de las dos partes se vectoriza. Aquí el trabajo se separa en dos etapas:
+ *   1. Rellenar un búfer de PALABRAS salidas del generador (pequeño, para que
+ *      quede en la caché L1)
+ *   2. Recorrer el búfer convirtiendo palabras en coordenadas y sumando el
+ *      estimador en un bucle sin saltos ni llamadas, que el compilador puede vectorizar
+ *
+ * La conversión a real se hace a mano en lugar de con uniform_real_distribution,
+ * por lo que la secuencia de puntos es distinta de la del bucle escalar. El tamaño
+ * del búfer no cambia el resultado: las palabras se consumen en el mismo orden.
+ *
+ * La variante "bufer" usa la resolución completa del tipo real; "dividido-64"
+ * saca las dos coordenadas de una sola palabra de 64 bits (ver PuntoDividido).
+ */
+
+// Palabra de salida del generador: 32 bits si su rango cabe en 32 bits
+template <class Motor>
+struct PalabraMotor {
+	typedef typename std::conditional<(Motor::max() > 0xffffffffu), uint64_t, uint32_t>::type tipo;
+};
+
+// Conversión de palabras a un real uniforme en [0, 1) con la resolución completa de Real
+template <class Palabra, class Real> struct ConversionPalabras;
+template <> struct ConversionPalabras<uint32_t, double> {
+	static const int palabras = 2;  // 27 + 26 bits, como genrand_res53 del Mersenne Twister original
+	static double convertir(const uint32_t* p) {
+		return ((p[0] >> 5) * 67108864.0 + (p[1] >> 6)) * (1.0 / 9007199254740992.0);
+	}
+};
+template <> struct ConversionPalabras<uint32_t, float> {
+	static const int palabras = 1;
+	static float convertir(const uint32_t* p) { return (p[0] >> 8) * (1.0f / 16777216.0f); }
+};
+template <> struct ConversionPalabras<uint64_t, double> {
+	static const int palabras = 1;
+	static double convertir(const uint64_t* p) { return (p[0] >> 11) * (1.0 / 9007199254740992.0); }
+};
+template <> struct ConversionPalabras<uint64_t, float> {
+	static const int palabras = 1;
+	static float convertir(const uint64_t* p) { return (uint32_t)(p[0] >> 40) * (1.0f / 16777216.0f); }
+};
+
+// Un punto con la resolución completa: cada coordenada con su propia conversión
+template <class Palabra, class Real>
+struct PuntoCompleto {
+	typedef ConversionPalabras<Palabra, Real> Conversion;
+	static const int palabras = 2 * Conversion::palabras;
+	static const int bits = std::numeric_limits<Real>::digits;
+	static void convertir(const Palabra* p, Real& x, Real& y) {
+		x = Conversion::convertir(p);
+		y = Conversion::convertir(p + Conversion::palabras);
+	}
+};
+
+/**
+ * Un punto a partir de una sola palabra de 64 bits: la mitad alta da x y la baja, y
+ *
+ * Se llama al generador la mitad de veces por punto, a cambio de resolución: con
+ * double cada coordenada tiene 32 bits en lugar de 53, es decir, los puntos caen
+ * en una rejilla de 2^32 x 2^32. El sesgo que introduce en π es del orden de
+ * 2^-32, muy por debajo del error estadístico de cualquier ejecución realista.
+ * Con float no se pierde nada: sus 24 bits caben en cada mitad.
+ */
+template <class Real> struct PuntoDividido;
+template <> struct PuntoDividido<double> {
+	static const int palabras = 1;
+	static const int bits = 32;
+	static void convertir(const uint64_t* p, double& x, double& y) {
+		x = (uint32_t)(p[0] >> 32) * (1.0 / 4294967296.0);
+		y = (uint32_t)p[0] * (1.0 / 4294967296.0);
+	}
+};
+template <> struct PuntoDividido<float> {
+	static const int palabras = 1;
+	static const int bits = 24;
+	static void convertir(const uint64_t* p, float& x, float& y) {
+		x = (uint32_t)(p[0] >> 40) * (1.0f / 16777216.0f);
+		y = ((uint32_t)p[0] >> 8) * (1.0f / 16777216.0f);
+	}
+};
+
+// Etapa 2 de la tubería: suma el estimador sobre los puntos de un búfer ya lleno
+template <class Real, class Est, class Punto, class Palabra>
+inline typename Est::Acumulador consumir_bufer(const Palabra* bufer, long long puntos) {
+	typename Est::Acumulador suma = 0;
+	for (long long k = 0; k < puntos; ++k) {
+		Real x, y;
+		Punto::convertir(bufer + k * Punto::palabras, x, y);
+		suma += Est::valor(x, y);
+	}
+	return suma;
+}
+
+// Bucle de la tubería con búfer, común a las formas de construir cada punto
+template <class Motor, class Real, class Est, int PALABRAS, class Punto>
+double sumar_bloque_palabras(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	const long long puntos_por_bufer = PALABRAS / Punto::palabras;
+
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+	long long saltar = desde - bloque * MUESTRAS_POR_BLOQUE;
+	if (saltar > 0) {
+		gen.discard(saltar * Punto::palabras);
+	}
+
+	Palabra bufer[PALABRAS];
+	typename Est::Acumulador suma = 0;
+	for (long long hecho = 0; hecho < hasta - desde; ) {
+		long long puntos = hasta - desde - hecho;
+		if (puntos > puntos_por_bufer) puntos = puntos_por_bufer;
+
+		// Etapa 1: generar todas las palabras del búfer seguidas
+		rellenar_palabras(gen, bufer, puntos * Punto::palabras);
+
+		// Etapa 2: consumir el búfer
+		suma += consumir_bufer<Real, Est, Punto>(bufer, puntos);
+		hecho += puntos;
+	}
+	return (double)suma;
+}
+
+template <class Motor, class Real, class Est, int PALABRAS>
+double sumar_bloque_bufer(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	return sumar_bloque_palabras<Motor, Real, Est, PALABRAS,
+		PuntoCompleto<typename PalabraMotor<Motor>::tipo, Real> >(semilla, bloque, desde, hasta);
+}
+
+// Solo para generadores de 64 bits (ver PuntoDividido)
+template <class Motor, class Real, class Est, int PALABRAS>
+double sumar_bloque_dividido(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	return sumar_bloque_palabras<Motor, Real, Est, PALABRAS, PuntoDividido<Real> >(semilla, bloque, desde, hasta);
+}
+
+/**
+ * VARIANTE ILP: K GENERADORES INTERCALADOS
+ *
+ * En el bucle escalar cada punto depende del estado del generador que dejó el
+ * anterior, y todos los aciertos se suman en la misma variable: dos cadenas de
+ * dependencias que limitan cuántas instrucciones puede solapar el procesador.
+ * Aquí cada bloque se divide en CARRILES_ILP carriles fijos, cada uno con su
+ * propio generador, y se recorren K carriles a la vez con K acumuladores. Así hay
+ * K cadenas independientes que el procesador ejecuta en paralelo aunque no
+ * haya SIMD.
+ *
+ * Los carriles no dependen de K (K solo decide cuántos se recorren juntos): cada
+ * carril se acumula por separado y las sumas de los carriles se combinan al
+ * final en orden de carril, así que el resultado es el mismo bit a bit para
+ * cualquier K, también con acumuladores double. A cambio, cada bloque siembra
+ * CARRILES_ILP generadores en lugar de uno.
+ */
+const int CARRILES_ILP = 8;
+const long long MUESTRAS_POR_CARRIL = MUESTRAS_POR_BLOQUE / CARRILES_ILP;
+
+// Siembra el generador de un carril a partir de (semilla, bloque, carril)
+template <class Motor>
+inline void sembrar_carril(Motor& gen, unsigned long long semilla, long long bloque, int carril) {
+	std::seed_seq secuencia{
+		static_cast<unsigned int>(semilla), static_cast<unsigned int>(semilla >> 32),
+		static_cast<unsigned int>(bloque), static_cast<unsigned int>(bloque >> 32),
+		static_cast<unsigned int>(carril + 1) };
+	gen.seed(secuencia);
+}
+
+// Recorre K carriles completos a la vez, desde el carril 'primero', y deja la
+// suma de cada uno en sumas[primero + k]
+template <class Motor, class Real, class Est, int K>
+inline void sumar_carriles(unsigned long long semilla, long long bloque, int primero,
+	typename Est::Acumulador* sumas) {
+	Motor gen[K];
+	Uniforme<Motor, Real> uniforme[K];
+	typename Est::Acumulador suma[K] = {};
+	for (int k = 0; k < K; ++k) {
+		sembrar_carril(gen[k], semilla, bloque, primero + k);
+	}
+
+	for (long long i = 0; i < MUESTRAS_POR_CARRIL; ++i) {
+		for (int k = 0; k < K; ++k) {
+			Real x = uniforme[k](gen[k]);
+			Real y = uniforme[k](gen[k]);
+			suma[k] += Est::valor(x, y);
+		}
+	}
+
+	for (int k = 0; k < K; ++k) {
+		sumas[primero + k] = suma[k];
+	}
+}
+
+template <class Motor, class Real, class Est, int K>
+double sumar_bloque_ilp(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	long long inicio = desde - bloque * MUESTRAS_POR_BLOQUE;
+	long long fin = hasta - bloque * MUESTRAS_POR_BLOQUE;
+	typename Est::Acumulador sumas[CARRILES_ILP] = {};  // Suma de cada carril (0 fuera del rango)
+
+	// Carriles completos dentro del rango, de K en K
+	int primero = (int)((inicio + MUESTRAS_POR_CARRIL - 1) / MUESTRAS_POR_CARRIL);
+	int ultimo = (int)(fin / MUESTRAS_POR_CARRIL);  // Carriles completos: [primero, ultimo)
+	int carril = primero;
+	for (; carril + K <= ultimo; carril += K) {
+		sumar_carriles<Motor, Real, Est, K>(semilla, bloque, carril, sumas);
+	}
+	for (; carril < ultimo; ++carril) {
+		sumar_carriles<Motor, Real, Est, 1>(semilla, bloque, carril, sumas);
+	}
+
+	// Trozos de carril en los extremos (solo si el rango empieza o acaba a mitad de carril)
+	for (int c = (int)(inicio / MUESTRAS_POR_CARRIL); c < CARRILES_ILP; ++c) {
+		long long desde_c = c * MUESTRAS_POR_CARRIL;
+		long long hasta_c = desde_c + MUESTRAS_POR_CARRIL;
+		if (c >= primero && c < ultimo) continue;
+		if (desde_c >= fin) break;
+		long long a = inicio > desde_c ? inicio : desde_c;
+		long long b = fin < hasta_c ? fin : hasta_c;
+		Motor gen;
+		sembrar_carril(gen, semilla, bloque, c);
+		if (a > desde_c) {
+			sumar_muestras<Motor, Real, Est, 1>(gen, a - desde_c);
+		}
+		sumas[c] = sumar_muestras<Motor, Real, Est, 1>(gen, b - a);
+	}
+
+	// Combinar en orden de carril, sin depender de K
+	typename Est::Acumulador suma = 0;
+	for (int c = 0; c < CARRILES_ILP; ++c) {
+		suma += sumas[c];
+	}
+	return (double)suma;
+}
+
+typedef double (*FuncionBloque)(unsigned long long semilla, long long bloque,
+	long long desde, long long hasta);
+
+// Entrada de la tabla de núcleos
+struct EntradaNucleo {
+	int generador;
+	int precision;
+	int estimador;
+	int variante;
+	int parametro;                              // Desenrollado (escalar), palabras (búfer) o K (ilp)
+	int bits_coordenada;                        // Resolución de cada coordenada
+	FuncionBloque sumar;                        // Suma de un rango dentro de un bloque
+	double (*a_pi)(double suma, long long n);   // Estimación de π a partir de la suma
+	double (*error_estandar)(double pi, long long n);  // Desviación típica de la estimación
+};
+
+#define NUCLEO(Motor, Real, Est, var, param, funcion, bits) \
+	{ IdGenerador<Motor>::id, IdPrecision<Real>::id, Est::id, var, param, bits, \
+	  &funcion<Motor, Real, Est, param>, &Est::a_pi, &Est::error_estandar }
+#define NUCLEOS_DESENROLLADOS(Motor, Real, Est) \
+	NUCLEO(Motor, Real, Est, VAR_ESCALAR, 1, sumar_bloque, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_ESCALAR, 2, sumar_bloque, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_ESCALAR, 4, sumar_bloque, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_BUFER, 256, sumar_bloque_bufer, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_BUFER, 1024, sumar_bloque_bufer, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_BUFER, 4096, sumar_bloque_bufer, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_ILP, 2, sumar_bloque_ilp, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_ILP, 4, sumar_bloque_ilp, std::numeric_limits<Real>::digits), \
+	NUCLEO(Motor, Real, Est, VAR_ILP, 8, sumar_bloque_ilp, std::numeric_limits<Real>::digits)
+#define NUCLEOS_DIVIDIDOS(Motor, Real, Est) \
+	NUCLEO(Motor, Real, Est, VAR_DIVIDIDO, 256, sumar_bloque_dividido, PuntoDividido<Real>::bits), \
+	NUCLEO(Motor, Real, Est, VAR_DIVIDIDO, 1024, sumar_bloque_dividido, PuntoDividido<Real>::bits), \
+	NUCLEO(Motor, Real, Est, VAR_DIVIDIDO, 4096, sumar_bloque_dividido, PuntoDividido<Real>::bits)
+
+// Todas las variantes de un generador (dividido-64 solo con palabras de 64 bits)
+#define NUCLEOS_MOTOR(Motor) \
+	NUCLEOS_DESENROLLADOS(Motor, double, EstimadorAciertos), \
+	NUCLEOS_DESENROLLADOS(Motor, float, EstimadorAciertos), \
+	NUCLEOS_DESENROLLADOS(Motor, double, EstimadorValorMedio), \
+	NUCLEOS_DESENROLLADOS(Motor, float, EstimadorValorMedio), \
+	NUCLEOS_DESENROLLADOS(Motor, double, EstimadorAciertosTabla), \
+	NUCLEOS_DESENROLLADOS(Motor, float, EstimadorAciertosTabla)
+#define NUCLEOS_MOTOR_64(Motor) \
+	NUCLEOS_MOTOR(Motor), \
+	NUCLEOS_DIVIDIDOS(Motor, double, EstimadorAciertos), \
+	NUCLEOS_DIVIDIDOS(Motor, float, EstimadorAciertos), \
+	NUCLEOS_DIVIDIDOS(Motor, double, EstimadorValorMedio), \
+	NUCLEOS_DIVIDIDOS(Motor, float, EstimadorValorMedio), \
+	NUCLEOS_DIVIDIDOS(Motor, double, EstimadorAciertosTabla), \
+	NUCLEOS_DIVIDIDOS(Motor, float, EstimadorAciertosTabla)
+
+// Todas las combinaciones instanciadas
+const EntradaNucleo TABLA_NUCLEOS[] = {
+	NUCLEOS_MOTOR(std::mt19937),
+	NUCLEOS_MOTOR_64(std::mt19937_64),
+	NUCLEOS_MOTOR_64(Xoshiro256x4),
+	NUCLEOS_MOTOR_64(Xoshiro256x8),
+	NUCLEOS_MOTOR_64(Xoshiro256x16),
+	NUCLEOS_MOTOR_64(AesCtr),
+};
+const int NUM_NUCLEOS = sizeof(TABLA_NUCLEOS) / sizeof(TABLA_NUCLEOS[0]);
+
+#undef NUCLEOS_MOTOR_64
+#undef NUCLEOS_MOTOR
+#undef NUCLEOS_DIVIDIDOS
+#undef NUCLEOS_DESENROLLADOS
+#undef NUCLEO
+
+/**
+ * Busca en la tabla la entrada con la combinación pedida
+ *
+ * @return La entrada, o nullptr si esa combinación no está instanciada
+ */
+inline const EntradaNucleo* buscar_nucleo(int generador, int precision, int estimador,
+	int variante, int parametro) {
+	for (int k = 0; k < NUM_NUCLEOS; k++) {
+		const EntradaNucleo& e = TABLA_NUCLEOS[k];
+		if (e.generador == generador && e.precision == precision && e.estimador == estimador &&
+			e.variante == variante && e.parametro == parametro) {
+			return &e;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * VOLUMEN DE LA BOLA UNIDAD EN D DIMENSIONES
+ *
+ * El acierto-fallo en [0, 1]^D no sirve en dimensiones altas: la fracción de
+ * aciertos es V_D / 2^D (unos 10^-15 con D = 32), así que no hay ningún
+ * acierto con un número razonable de muestras. En su lugar se usa muestreo por
+ * importancia con una propuesta gaussiana: con x ~ N(0, σ²·I) en R^D,
+ *
+ *     V_D = E[ 1{|x| <= 1} / φ(x) ],   1 / φ(x) = (2πσ²)^(D/2) · exp(|x|² / 2σ²)
+ *
+ * Con σ² = 1/D los puntos caen cerca de la esfera unidad: más de la mitad
+ * quedan dentro y la varianza relativa por muestra es baja en todas las
+ * dimensiones (0,7 con D = 2, 4,1 con D = 32). Escribiendo |x|² = Q/D, la suma
+ * de cada bloque es la de exp(Q/2) en las muestras con Q <= D, y el volumen es
+ * constante_bola(D) = (2π/D)^(D/2) por la media de esa suma.
+ *
+ * Solo hace falta Q = |g|² para g ~ N(0, I) en D coordenadas: cada par de
+ * coordenadas aporta g1² + g2² = -2·log(1 - u), el radio de Box-Muller sin el
+ * ángulo, y con D impar la última coordenada es -2·log(1 - u)·cos²(2πv). Cada
+ * muestra consume D/2 uniformes (2 más con D impar) del búfer. D se fija al
+ * compilar (de 2 a 32), así que el bucle se desenrolla por completo. Q se
+ * reparte en CARRILES_BOLA sumas parciales (el par j va a la suma
+ * j % CARRILES_BOLA) para no depender de una única cadena de sumas; las sumas
+ * se combinan en orden fijo, así que el resultado no cambia con el compilador
+ * ni con el número de hilos.
+ */
+const int DIMENSION_MIN_BOLA = 2;
+const int DIMENSION_MAX_BOLA = 32;
+const int CARRILES_BOLA = 4;
+const int PALABRAS_BUFER_BOLA = 2048;
+
+// Uniformes que consume cada muestra de la bola en D dimensiones
+inline constexpr int uniformes_bola(int D) { return D / 2 + 2 * (D % 2); }
+
+// Factor (2πσ²)^(D/2) con σ² = 1/D: volumen = constante_bola(D) · media de la suma
+inline double constante_bola(int D) {
+	return pow(2.0 * 3.14159265358979323846 / D, 0.5 * D);
+}
+
+// Etapa 2 para la bola: suma de exp(Q/2) en los puntos del búfer con Q <= D
+template <class Palabra, class Real, int D>
+inline double consumir_bufer_bola(const Palabra* bufer, long long puntos) {
+	typedef ConversionPalabras<Palabra, Real> Conversion;
+	const int palabras_punto = uniformes_bola(D) * Conversion::palabras;
+	const Real dos_pi = Real(6.28318530717958647692);
+	double suma = 0.0;
+	for (long long k = 0; k < puntos; ++k) {
+		const Palabra* p = bufer + k * palabras_punto;
+		Real parcial[CARRILES_BOLA] = {};
+		for (int j = 0; j < D / 2; ++j) {
+			Real u = Conversion::convertir(p + j * Conversion::palabras);
+			parcial[j % CARRILES_BOLA] += Real(-2) * log(Real(1) - u);
+		}
+		if (D % 2 != 0) {
+			Real u = Conversion::convertir(p + (D / 2) * Conversion::palabras);
+			Real v = Conversion::convertir(p + (D / 2 + 1) * Conversion::palabras);
+			Real c = cos(dos_pi * v);
+			parcial[(D / 2) % CARRILES_BOLA] += Real(-2) * log(Real(1) - u) * c * c;
+		}
+		Real q = 0;
+		for (int c = 0; c < CARRILES_BOLA; ++c) {
+			q += parcial[c];
+		}
+		if (q <= Real(D)) {
+			suma += exp(0.5 * (double)q);
+		}
+	}
+	return suma;
+}
+
+template <class Motor, class Real, int D>
+double sumar_bloque_bola(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	const long long palabras_punto = uniformes_bola(D) * ConversionPalabras<Palabra, Real>::palabras;
+	const long long puntos_por_bufer = PALABRAS_BUFER_BOLA / palabras_punto;
+
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+	long long saltar = desde - bloque * MUESTRAS_POR_BLOQUE;
+	if (saltar > 0) {
+		gen.discard(saltar * palabras_punto);
+	}
+
+	Palabra bufer[PALABRAS_BUFER_BOLA];
+	double suma = 0.0;
+	for (long long hecho = 0; hecho < hasta - desde; ) {
+		long long puntos = hasta - desde - hecho;
+		if (puntos > puntos_por_bufer) puntos = puntos_por_bufer;
+		rellenar_palabras(gen, bufer, puntos * palabras_punto);
+		suma += consumir_bufer_bola<Palabra, Real, D>(bufer, puntos);
+		hecho += puntos;
+	}
+	return suma;
+}
+
+// Entrada de la tabla de núcleos de la bola (siempre en double)
+struct EntradaBola {
+	int generador;
+	int dimension;
+	FuncionBloque sumar;
+};
+
+#define BOLA(Motor, D) { IdGenerador<Motor>::id, D, &sumar_bloque_bola<Motor, double, D> }
+#define BOLAS_MOTOR(Motor) \
+	BOLA(Motor, 2), BOLA(Motor, 3), BOLA(Motor, 4), BOLA(Motor, 5), BOLA(Motor, 6), \
+	BOLA(Motor, 7), BOLA(Motor, 8), BOLA(Motor, 9), BOLA(Motor, 10), BOLA(Motor, 11), \
+	BOLA(Motor, 12), BOLA(Motor, 13), BOLA(Motor, 14), BOLA(Motor, 15), BOLA(Motor, 16), \
+	BOLA(Motor, 17), BOLA(Motor, 18), BOLA(Motor, 19), BOLA(Motor, 20), BOLA(Motor, 21), \
+	BOLA(Motor, 22), BOLA(Motor, 23), BOLA(Motor, 24), BOLA(Motor, 25), BOLA(Motor, 26), \
+	BOLA(Motor, 27), BOLA(Motor, 28), BOLA(Motor, 29), BOLA(Motor, 30), BOLA(Motor, 31), \
+	BOLA(Motor, 32)
+
+const EntradaBola TABLA_BOLAS[] = {
+	BOLAS_MOTOR(std::mt19937),
+	BOLAS_MOTOR(std::mt19937_64),
+	BOLAS_MOTOR(Xoshiro256x4),
+	BOLAS_MOTOR(Xoshiro256x8),
+	BOLAS_MOTOR(Xoshiro256x16),
+	BOLAS_MOTOR(AesCtr),
+};
+const int NUM_BOLAS = sizeof(TABLA_BOLAS) / sizeof(TABLA_BOLAS[0]);
+
+#undef BOLAS_MOTOR
+#undef BOLA
+
+// @return La entrada para ese generador y dimensión, o nullptr si no está instanciada
+inline const EntradaBola* buscar_bola(int generador, int dimension) {
+	for (int k = 0; k < NUM_BOLAS; k++) {
+		if (TABLA_BOLAS[k].generador == generador && TABLA_BOLAS[k].dimension == dimension) {
+			return &TABLA_BOLAS[k];
+		}
+	}
+	return nullptr;
+}
+
+// Volumen exacto de la bola unidad: π^(D/2) / Γ(D/2 + 1)
+inline double volumen_bola(int dimension, double pi) {
+	return pow(pi, dimension / 2.0) / tgamma(dimension / 2.0 + 1.0);
+}
+
+// π a partir de una estimación del volumen (inversa de volumen_bola)
+inline double pi_desde_volumen(int dimension, double volumen) {
+	return pow(volumen * tgamma(dimension / 2.0 + 1.0), 2.0 / dimension);
+}
+
+/**
+ * ESTIMADORES GEOMÉTRICOS DE BUFFON
+ *
+ * Aguja de Buffon: una aguja de longitud 1 cae sobre rectas paralelas separadas
+ * 1 y las cruza con probabilidad 2/π. Buffon-Laplace: la misma aguja sobre una
+ * cuadrícula de 1 x 1 cruza alguna línea con probabilidad (2l(a+b) - l²)/(πab) = 3/π.
+ * En ambos casos π = constante · n / cruces.
+ *
+ * La dirección de la aguja se obtiene sin trigonometría: (u, v) uniforme en el
+ * cuadrado [0, 1]² se acepta si cae en el cuarto de círculo (rechazo), y
+ * entonces cos θ = u/r, sen θ = v/r con r² = u² + v². Con la distancia del
+ * centro a la recta más cercana c·(1/2), la aguja cruza si c·r <= v; elevando al
+ * cuadrado, c²·r² <= v², sin raíces ni divisiones.
+ *
+ * Los candidatos se evalúan por lotes desde el búfer de palabras, sin saltos
+ * (aceptación y cruce se calculan siempre y se combinan con &), así que el bucle
+ * se puede vectorizar. La muestra i del bloque es el i-ésimo candidato aceptado,
+ * de modo que un rango que empieza a mitad de bloque recorre los candidatos
+ * anteriores sin contarlos y el resultado no depende del reparto entre hilos.
+ */
+enum ExperimentoBuffon { BUFFON_AGUJA, BUFFON_LAPLACE, NUM_EXPERIMENTOS_BUFFON };
+const char* const NOMBRES_BUFFON[] = { "aguja", "laplace" };
+
+// Candidatos que se generan y evalúan de cada vez
+const int CANDIDATOS_LOTE_BUFFON = 256;
+
+// Coordenadas: distancia a la recta (c0) y dirección (u, v)
+struct AgujaBuffon {
+	static const int coordenadas = 3;
+	static const int id = BUFFON_AGUJA;
+	static double constante() { return 2.0; }
+	static bool cruza(const double* c, double r2) { return c[0] * c[0] * r2 <= c[2] * c[2]; }
+};
+
+// Coordenadas: distancias a la línea vertical (c0) y horizontal (c1) más cercanas y dirección (u, v)
+struct AgujaBuffonLaplace {
+	static const int coordenadas = 4;
+	static const int id = BUFFON_LAPLACE;
+	static double constante() { return 3.0; }
+	static bool cruza(const double* c, double r2) {
+		return (c[0] * c[0] * r2 <= c[2] * c[2]) | (c[1] * c[1] * r2 <= c[3] * c[3]);
+	}
+};
+
+template <class Motor, class Experimento>
+double sumar_bloque_buffon(unsigned long long semilla, long long bloque, long long desde, long long hasta) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	typedef ConversionPalabras<Palabra, double> Conversion;
+	const int C = Experimento::coordenadas;
+	const int palabras_candidato = C * Conversion::palabras;
+
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+
+	// Muestras (candidatos aceptados) del bloque que hay que contar: [saltar, fin)
+	const long long saltar = desde - bloque * MUESTRAS_POR_BLOQUE;
+	const long long fin = hasta - bloque * MUESTRAS_POR_BLOQUE;
+
+	Palabra palabras[CANDIDATOS_LOTE_BUFFON * palabras_candidato];
+	unsigned char aceptado[CANDIDATOS_LOTE_BUFFON], cruce[CANDIDATOS_LOTE_BUFFON];
+	long long aceptados = 0;
+	unsigned long long cruces = 0;
+	while (aceptados < fin) {
+		rellenar_palabras(gen, palabras, (long long)CANDIDATOS_LOTE_BUFFON * palabras_candidato);
+		int aceptados_lote = 0, cruces_lote = 0;
+		for (int k = 0; k < CANDIDATOS_LOTE_BUFFON; ++k) {
+			double c[C];
+			for (int d = 0; d < C; ++d) {
+				c[d] = Conversion::convertir(palabras + (k * C + d) * Conversion::palabras);
+			}
+			double r2 = c[C - 2] * c[C - 2] + c[C - 1] * c[C - 1];
+			unsigned char a = (r2 <= 1.0) & (r2 > 0.0);
+			aceptado[k] = a;
+			cruce[k] = a & (unsigned char)Experimento::cruza(c, r2);
+			aceptados_lote += aceptado[k];
+			cruces_lote += cruce[k];
+		}
+
+		if (aceptados >= saltar && aceptados + aceptados_lote <= fin) {
+			cruces += cruces_lote;
+			aceptados += aceptados_lote;
+		}
+		else if (aceptados + aceptados_lote <= saltar) {
+			aceptados += aceptados_lote;
+		}
+		else {
+			// El lote contiene un extremo del rango: recorrerlo uno a uno
+			for (int k = 0; k < CANDIDATOS_LOTE_BUFFON && aceptados < fin; ++k) {
+				if (!aceptado[k]) continue;
+				if (aceptados >= saltar) cruces += cruce[k];
+				aceptados++;
+			}
+		}
+	}
+	return (double)cruces;
+}
+
+// π a partir de los cruces: π = constante · n / cruces
+template <class Experimento>
+inline double buffon_a_pi(double cruces, long long n) {
+	return cruces > 0 ? Experimento::constante() * n / cruces : 0.0;
+}
+
+// Con p = constante/π y cruces ~ Bin(n, p): error de π ~ π · sqrt((1 - p) / (n·p))
+template <class Experimento>
+inline double buffon_error_estandar(double pi, long long n) {
+	if (pi <= 0.0) return 0.0;
+	double p = Experimento::constante() / pi;
+	return pi * sqrt((1.0 - p) / (n * p));
+}
+
+struct EntradaBuffon {
+	int generador;
+	int experimento;
+	FuncionBloque sumar;
+	double (*a_pi)(double cruces, long long n);
+	double (*error_estandar)(double pi, long long n);
+};
+
+#define BUFFON(Motor, Exp) { IdGenerador<Motor>::id, Exp::id, &sumar_bloque_buffon<Motor, Exp>, \
+	&buffon_a_pi<Exp>, &buffon_error_estandar<Exp> }
+#define BUFFON_MOTOR(Motor) BUFFON(Motor, AgujaBuffon), BUFFON(Motor, AgujaBuffonLaplace)
+
+const EntradaBuffon TABLA_BUFFON[] = {
+	BUFFON_MOTOR(std::mt19937),
+	BUFFON_MOTOR(std::mt19937_64),
+	BUFFON_MOTOR(Xoshiro256x4),
+	BUFFON_MOTOR(Xoshiro256x8),
+	BUFFON_MOTOR(Xoshiro256x16),
+	BUFFON_MOTOR(AesCtr),
+};
+const int NUM_BUFFON = sizeof(TABLA_BUFFON) / sizeof(TABLA_BUFFON[0]);
+
+#undef BUFFON_MOTOR
+#undef BUFFON
+
+// @return La entrada para ese generador y experimento, o nullptr si no está instanciada
+inline const EntradaBuffon* buscar_buffon(int generador, int experimento) {
+	for (int k = 0; k < NUM_BUFFON; k++) {
+		if (TABLA_BUFFON[k].generador == generador && TABLA_BUFFON[k].experimento == experimento) {
+			return &TABLA_BUFFON[k];
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * PASADA CONJUNTA DE VARIOS ESTIMADORES
+ *
+ * Cada punto (x, y) se genera una sola vez y alimenta a la vez a tres
+ * estimadores de π:
+ *   - Acierto-fallo:  4·[x² + y² <= 1]
+ *   - Valor medio:    4·(g(x) + g(y)) / 2, con g(t) = sqrt(1 - t²)
+ *   - Antitético:     4·(g(x) + g(1 - x) + g(y) + g(1 - y)) / 4
+ *
+ * Además de la suma de cada estimador se acumulan los productos cruzados, así
+ * que con una sola pasada se obtienen las varianzas y covarianzas. Al usar los
+ * mismos números aleatorios (CRN), la diferencia entre dos estimadores tiene
+ * varianza v_i + v_j - 2·c_ij, mucho menor que con flujos independientes, y la
+ * comparación no añade ruido propio.
+ */
+enum EstimadorConjunto { CONJ_ACIERTOS, CONJ_VALOR_MEDIO, CONJ_ANTITETICO, NUM_ESTIMADORES_CONJUNTOS };
+const char* const NOMBRES_CONJUNTOS[] = { "aciertos", "valor-medio", "antitetico" };
+
+// Palabras del búfer de la pasada conjunta
+const int PALABRAS_BUFER_CONJUNTO = 1024;
+
+struct SumasConjuntas {
+	double suma[NUM_ESTIMADORES_CONJUNTOS];
+	double productos[NUM_ESTIMADORES_CONJUNTOS][NUM_ESTIMADORES_CONJUNTOS];  // Suma de f_i·f_j
+
+	SumasConjuntas& operator+=(const SumasConjuntas& otras) {
+		for (int i = 0; i < NUM_ESTIMADORES_CONJUNTOS; i++) {
+			suma[i] += otras.suma[i];
+			for (int j = 0; j < NUM_ESTIMADORES_CONJUNTOS; j++) {
+				productos[i][j] += otras.productos[i][j];
+			}
+		}
+		return *this;
+	}
+};
+
+/**
+ * Suma los tres estimadores (en unidades de π/4) y sus productos en las n
+ * primeras muestras de un bloque
+ */
+template <class Motor>
+void sumar_bloque_conjunto(unsigned long long semilla, long long bloque, long long n, SumasConjuntas& s) {
+	typedef typename PalabraMotor<Motor>::tipo Palabra;
+	typedef PuntoCompleto<Palabra, double> Punto;
+	const long long puntos_bufer = PALABRAS_BUFER_CONJUNTO / Punto::palabras;
+
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+	Palabra bufer[PALABRAS_BUFER_CONJUNTO];
+
+	double a = 0, m = 0, t = 0;
+	double aa = 0, mm = 0, tt = 0, am = 0, at = 0, mt = 0;
+	for (long long hecho = 0; hecho < n; ) {
+		long long puntos = n - hecho < puntos_bufer ? n - hecho : puntos_bufer;
+		rellenar_palabras(gen, bufer, puntos * Punto::palabras);
+		for (long long k = 0; k < puntos; ++k) {
+			double x, y;
+			Punto::convertir(bufer + k * Punto::palabras, x, y);
+			double gx = sqrt(1.0 - x * x), gy = sqrt(1.0 - y * y);
+			double gx_ = sqrt(1.0 - (1.0 - x) * (1.0 - x)), gy_ = sqrt(1.0 - (1.0 - y) * (1.0 - y));
+			double acierto = x * x + y * y <= 1.0 ? 1.0 : 0.0;
+			double medio = 0.5 * (gx + gy);
+			double antitetico = 0.25 * (gx + gx_ + gy + gy_);
+			a += acierto; m += medio; t += antitetico;
+			aa += acierto; mm += medio * medio; tt += antitetico * antitetico;
+			am += acierto * medio; at += acierto * antitetico; mt += medio * antitetico;
+		}
+		hecho += puntos;
+	}
+
+	s.suma[CONJ_ACIERTOS] = a;
+	s.suma[CONJ_VALOR_MEDIO] = m;
+	s.suma[CONJ_ANTITETICO] = t;
+	s.productos[CONJ_ACIERTOS][CONJ_ACIERTOS] = aa;
+	s.productos[CONJ_VALOR_MEDIO][CONJ_VALOR_MEDIO] = mm;
+	s.productos[CONJ_ANTITETICO][CONJ_ANTITETICO] = tt;
+	s.productos[CONJ_ACIERTOS][CONJ_VALOR_MEDIO] = s.productos[CONJ_VALOR_MEDIO][CONJ_ACIERTOS] = am;
+	s.productos[CONJ_ACIERTOS][CONJ_ANTITETICO] = s.productos[CONJ_ANTITETICO][CONJ_ACIERTOS] = at;
+	s.productos[CONJ_VALOR_MEDIO][CONJ_ANTITETICO] = s.productos[CONJ_ANTITETICO][CONJ_VALOR_MEDIO] = mt;
+}
+
+typedef void (*FuncionBloqueConjunto)(unsigned long long semilla, long long bloque, long long n,
+	SumasConjuntas& sumas);
+
+struct EntradaConjunta {
+	int generador;
+	FuncionBloqueConjunto sumar;
+};
+
+#define CONJUNTO(Motor) { IdGenerador<Motor>::id, &sumar_bloque_conjunto<Motor> }
+
+const EntradaConjunta TABLA_CONJUNTA[] = {
+	CONJUNTO(std::mt19937),
+	CONJUNTO(std::mt19937_64),
+	CONJUNTO(Xoshiro256x4),
+	CONJUNTO(Xoshiro256x8),
+	CONJUNTO(Xoshiro256x16),
+	CONJUNTO(AesCtr),
+};
+const int NUM_CONJUNTAS = sizeof(TABLA_CONJUNTA) / sizeof(TABLA_CONJUNTA[0]);
+
+#undef CONJUNTO
+
+// @return La entrada para ese generador, o nullptr si no está instanciada
+inline const EntradaConjunta* buscar_conjunto(int generador) {
+	for (int k = 0; k < NUM_CONJUNTAS; k++) {
+		if (TABLA_CONJUNTA[k].generador == generador) {
+			return &TABLA_CONJUNTA[k];
+		}
+	}
+	return nullptr;
+}
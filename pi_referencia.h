@@ -0,0 +1,617 @@
+/******************************************************************************
+ * VALOR DE REFERENCIA DE π (SERIE DE CHUDNOVSKY)
+ *****************************************************************************
+ *
+ * Calcula π con tantas cifras como se pida, para comparar las estimaciones con
+ * el valor verdadero y como segunda carga de trabajo (intensiva en CPU) para
+ * las pruebas de escalado.
+ *
+ *   π = 426880 · sqrt(10005) · Q(0, n) / T(0, n)
+ *
+ * donde P, Q y T se obtienen por división binaria (binary splitting) de los n
+ * términos de la serie, que aporta unas 14,18 cifras por término. Todo se hace
+ * con enteros en coma fija binaria: el resultado es floor(π · 2^B).
+ *
+ * Paralelización (solo con construcciones de OpenMP 2.0, las que admite MSVC
+ * con /openmp): los n términos se reparten en varios tramos que se calculan a la
+ * vez con un parallel for, y los tramos se combinan por niveles como un árbol
+ * binario. En los niveles altos, donde quedan menos pares que hilos, las
+ * multiplicaciones de cada combinación se reparten con parallel sections. La
+ * raíz y la división finales reparten a su vez los tres productos del primer
+ * nivel de Karatsuba.
+ *
+ * Incluye una aritmética de enteros grandes mínima: palabras de 32 bits, suma,
+ * resta, multiplicación de Karatsuba, división (algoritmo D de Knuth o inverso
+ * de Newton según el tamaño) e inversa de la raíz cuadrada por Newton.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdint.h>
+#include <math.h>
+#include <omp.h>
+
+// Número natural grande: palabras de 32 bits, la menos significativa primero,
+// sin ceros a la izquierda (el cero es el vector vacío)
+typedef std::vector<uint32_t> NumeroGrande;
+
+// Por debajo de este número de palabras la multiplicación escolar es más rápida que Karatsuba
+const size_t UMBRAL_KARATSUBA = 48;
+
+inline void normalizar_grande(NumeroGrande& a) {
+	while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+inline NumeroGrande grande_desde(unsigned long long v) {
+	NumeroGrande a;
+	for (; v > 0; v >>= 32) a.push_back((uint32_t)v);
+	return a;
+}
+
+inline long long bits_grande(const NumeroGrande& a) {
+	if (a.empty()) return 0;
+	long long bits = 32 * (long long)(a.size() - 1);
+	for (uint32_t alto = a.back(); alto > 0; alto >>= 1) bits++;
+	return bits;
+}
+
+inline int comparar_grande(const NumeroGrande& a, const NumeroGrande& b) {
+	if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+	for (size_t i = a.size(); i-- > 0;) {
+		if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+// r += a · 2^(32 · desplazamiento)
+inline void sumar_en_grande(NumeroGrande& r, const NumeroGrande& a, size_t desplazamiento = 0) {
+	if (r.size() < a.size() + desplazamiento) r.resize(a.size() + desplazamiento, 0);
+	uint64_t acarreo = 0;
+	size_t i = 0;
+	for (; i < a.size(); ++i) {
+		uint64_t t = (uint64_t)r[i + desplazamiento] + a[i] + acarreo;
+		r[i + desplazamiento] = (uint32_t)t;
+		acarreo = t >> 32;
+	}
+	for (size_t k = i + desplazamiento; acarreo != 0; ++k) {
+		if (k == r.size()) r.push_back(0);
+		uint64_t t = (uint64_t)r[k] + acarreo;
+		r[k] = (uint32_t)t;
+		acarreo = t >> 32;
+	}
+}
+
+inline NumeroGrande sumar_grande(const NumeroGrande& a, const NumeroGrande& b) {
+	NumeroGrande r = a;
+	sumar_en_grande(r, b);
+	return r;
+}
+
+// r -= a, con r >= a
+inline void restar_en_grande(NumeroGrande& r, const NumeroGrande& a) {
+	int64_t prestamo = 0;
+	for (size_t i = 0; i < r.size(); ++i) {
+		int64_t t = (int64_t)r[i] - (i < a.size() ? a[i] : 0) - prestamo;
+		prestamo = t < 0;
+		r[i] = (uint32_t)(t + (prestamo << 32));
+		if (i >= a.size() && prestamo == 0) break;
+	}
+	normalizar_grande(r);
+}
+
+inline NumeroGrande multiplicar_pequeno_grande(const NumeroGrande& a, uint32_t m) {
+	NumeroGrande r(a.size() + 1);
+	uint64_t acarreo = 0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		uint64_t t = (uint64_t)a[i] * m + acarreo;
+		r[i] = (uint32_t)t;
+		acarreo = t >> 32;
+	}
+	r[a.size()] = (uint32_t)acarreo;
+	normalizar_grande(r);
+	return r;
+}
+
+// Cociente de a / d; el resto se deja en 'resto'
+inline NumeroGrande dividir_pequeno_grande(const NumeroGrande& a, uint32_t d, uint32_t& resto) {
+	NumeroGrande q(a.size());
+	uint64_t r = 0;
+	for (size_t i = a.size(); i-- > 0;) {
+		uint64_t t = (r << 32) | a[i];
+		q[i] = (uint32_t)(t / d);
+		r = t % d;
+	}
+	resto = (uint32_t)r;
+	normalizar_grande(q);
+	return q;
+}
+
+inline NumeroGrande desplazar_izquierda_grande(const NumeroGrande& a, long long bits) {
+	if (a.empty()) return a;
+	size_t palabras = (size_t)(bits / 32);
+	int s = (int)(bits % 32);
+	NumeroGrande r(a.size() + palabras + 1, 0);
+	for (size_t i = 0; i < a.size(); ++i) {
+		uint64_t t = (uint64_t)a[i] << s;
+		r[i + palabras] |= (uint32_t)t;
+		r[i + palabras + 1] |= (uint32_t)(t >> 32);
+	}
+	normalizar_grande(r);
+	return r;
+}
+
+inline NumeroGrande desplazar_derecha_grande(const NumeroGrande& a, long long bits) {
+	size_t palabras = (size_t)(bits / 32);
+	int s = (int)(bits % 32);
+	if (palabras >= a.size()) return NumeroGrande();
+	NumeroGrande r(a.size() - palabras);
+	for (size_t i = 0; i < r.size(); ++i) {
+		uint64_t t = a[i + palabras];
+		if (i + palabras + 1 < a.size()) t |= (uint64_t)a[i + palabras + 1] << 32;
+		r[i] = (uint32_t)(t >> s);
+	}
+	normalizar_grande(r);
+	return r;
+}
+
+// Multiplicación escolar de a (na palabras) por b (nb): r debe tener na + nb palabras a cero
+inline void multiplicar_escolar(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* r) {
+	for (size_t i = 0; i < na; ++i) {
+		uint64_t acarreo = 0;
+		for (size_t j = 0; j < nb; ++j) {
+			uint64_t t = (uint64_t)a[i] * b[j] + r[i + j] + acarreo;
+			r[i + j] = (uint32_t)t;
+			acarreo = t >> 32;
+		}
+		r[i + nb] = (uint32_t)acarreo;
+	}
+}
+
+/**
+ * Multiplicación de Karatsuba: con a = a1·X + a0 y b = b1·X + b0,
+ * a·b = a1b1·X² + ((a0 + a1)(b0 + b1) - a0b0 - a1b1)·X + a0b0,
+ * tres productos de la mitad de tamaño en lugar de cuatro
+ *
+ * @param hilos: Si es mayor que 1, los tres productos del primer nivel se
+ *               calculan a la vez (los niveles inferiores, en serie)
+ */
+inline NumeroGrande multiplicar_grande(const NumeroGrande& a, const NumeroGrande& b, int hilos = 1) {
+	if (a.empty() || b.empty()) return NumeroGrande();
+	if (a.size() < UMBRAL_KARATSUBA || b.size() < UMBRAL_KARATSUBA) {
+		NumeroGrande r(a.size() + b.size(), 0);
+		multiplicar_escolar(a.data(), a.size(), b.data(), b.size(), r.data());
+		normalizar_grande(r);
+		return r;
+	}
+
+	size_t mitad = (a.size() > b.size() ? a.size() : b.size()) / 2;
+	NumeroGrande a0(a.begin(), a.begin() + (mitad < a.size() ? mitad : a.size()));
+	NumeroGrande a1(a.begin() + (mitad < a.size() ? mitad : a.size()), a.end());
+	NumeroGrande b0(b.begin(), b.begin() + (mitad < b.size() ? mitad : b.size()));
+	NumeroGrande b1(b.begin() + (mitad < b.size() ? mitad : b.size()), b.end());
+	normalizar_grande(a0);
+	normalizar_grande(b0);
+
+	NumeroGrande z0, z1, z2;
+#pragma omp parallel sections if(hilos > 1) num_threads(hilos < 3 ? hilos : 3)
+	{
+#pragma omp section
+		{ z0 = multiplicar_grande(a0, b0); }
+#pragma omp section
+		{ z2 = multiplicar_grande(a1, b1); }
+#pragma omp section
+		{ z1 = multiplicar_grande(sumar_grande(a0, a1), sumar_grande(b0, b1)); }
+	}
+	restar_en_grande(z1, z0);
+	restar_en_grande(z1, z2);
+
+	NumeroGrande r = z0;
+	sumar_en_grande(r, z1, mitad);
+	sumar_en_grande(r, z2, 2 * mitad);
+	normalizar_grande(r);
+	return r;
+}
+
+/**
+ * División larga (algoritmo D de Knuth, TAOCP vol. 2, 4.3.1)
+ *
+ * @param u, v: Dividendo y divisor (v distinto de cero)
+ * @param cociente, resto: Resultado
+ */
+inline void dividir_grande_knuth(const NumeroGrande& u, const NumeroGrande& v,
+	NumeroGrande& cociente, NumeroGrande& resto) {
+	if (comparar_grande(u, v) < 0) {
+		cociente.clear();
+		resto = u;
+		return;
+	}
+	if (v.size() == 1) {
+		uint32_t r;
+		cociente = dividir_pequeno_grande(u, v[0], r);
+		resto = grande_desde(r);
+		return;
+	}
+
+	// Normalizar para que la palabra alta del divisor tenga su bit alto a 1
+	int s = 0;
+	for (uint32_t alto = v.back(); (alto & 0x80000000u) == 0; alto <<= 1) s++;
+	size_t n = v.size(), m = u.size();
+	NumeroGrande vn(n), un(m + 1);
+	for (size_t i = n - 1; i > 0; --i) vn[i] = (v[i] << s) | (uint32_t)(((uint64_t)v[i - 1] << s) >> 32);
+	vn[0] = v[0] << s;
+	un[m] = (uint32_t)(((uint64_t)u[m - 1] << s) >> 32);
+	for (size_t i = m - 1; i > 0; --i) un[i] = (u[i] << s) | (uint32_t)(((uint64_t)u[i - 1] << s) >> 32);
+	un[0] = u[0] << s;
+
+	const uint64_t BASE = (uint64_t)1 << 32;
+	cociente.assign(m - n + 1, 0);
+	for (size_t j = m - n + 1; j-- > 0;) {
+		// Estimar la cifra del cociente con las dos palabras altas y corregirla
+		uint64_t numerador = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+		uint64_t qhat = numerador / vn[n - 1];
+		uint64_t rhat = numerador % vn[n - 1];
+		while (qhat >= BASE || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+			qhat--;
+			rhat += vn[n - 1];
+			if (rhat >= BASE) break;
+		}
+
+		// Restar qhat · v del tramo actual del dividendo
+		int64_t prestamo = 0;
+		for (size_t i = 0; i < n; ++i) {
+			uint64_t p = qhat * vn[i];
+			int64_t t = (int64_t)un[i + j] - prestamo - (int64_t)(p & 0xffffffffu);
+			un[i + j] = (uint32_t)t;
+			prestamo = (int64_t)(p >> 32) - (t >> 32);
+		}
+		int64_t t = (int64_t)un[j + n] - prestamo;
+		un[j + n] = (uint32_t)t;
+
+		// qhat era una unidad de más: volver a sumar v
+		if (t < 0) {
+			qhat--;
+			uint64_t acarreo = 0;
+			for (size_t i = 0; i < n; ++i) {
+				uint64_t suma = (uint64_t)un[i + j] + vn[i] + acarreo;
+				un[i + j] = (uint32_t)suma;
+				acarreo = suma >> 32;
+			}
+			un[j + n] += (uint32_t)acarreo;
+		}
+		cociente[j] = (uint32_t)qhat;
+	}
+	normalizar_grande(cociente);
+
+	// Deshacer la normalización en el resto
+	resto.assign(n, 0);
+	for (size_t i = 0; i < n; ++i) {
+		resto[i] = (uint32_t)((((uint64_t)un[i + 1] << 32) | un[i]) >> s);
+	}
+	normalizar_grande(resto);
+}
+
+// A partir de este tamaño (en palabras) del divisor y del cociente se divide por Newton
+const size_t UMBRAL_DIVISION_NEWTON = 4 * UMBRAL_KARATSUBA;
+
+/**
+ * Inverso en coma fija: aproxima 2^(2W) / w, con W = bits de w, salvo unas
+ * pocas unidades. Cada paso de Newton r = r + r·(2^2W - w·r) / 2^2W duplica los
+ * bits correctos, así que basta con el inverso de la mitad alta de w.
+ */
+inline NumeroGrande inverso_grande(const NumeroGrande& w, int hilos = 1) {
+	long long W = bits_grande(w);
+	if (w.size() < UMBRAL_DIVISION_NEWTON) {
+		NumeroGrande cociente, resto;
+		dividir_grande_knuth(desplazar_izquierda_grande(grande_desde(1), 2 * W), w, cociente, resto);
+		return cociente;
+	}
+
+	long long h = W / 2 + 1;
+	NumeroGrande r = desplazar_izquierda_grande(inverso_grande(desplazar_derecha_grande(w, W - h), hilos), W - h);
+	NumeroGrande potencia = desplazar_izquierda_grande(grande_desde(1), 2 * W);
+	NumeroGrande producto = multiplicar_grande(w, r, hilos);
+	if (comparar_grande(producto, potencia) <= 0) {
+		restar_en_grande(potencia, producto);
+		sumar_en_grande(r, desplazar_derecha_grande(multiplicar_grande(r, potencia, hilos), 2 * W));
+	}
+	else {
+		restar_en_grande(producto, potencia);
+		restar_en_grande(r, desplazar_derecha_grande(multiplicar_grande(r, producto, hilos), 2 * W));
+	}
+	normalizar_grande(r);
+	return r;
+}
+
+/**
+ * División entera
+ *
+ * Para operandos pequeños, división larga. Para grandes, cociente aproximado
+ * u · (1/v) con el inverso de Newton (coste de unas pocas multiplicaciones de
+ * Karatsuba en lugar de cuadrático) y corrección final con el resto.
+ *
+ * @param u, v: Dividendo y divisor (v distinto de cero)
+ * @param cociente, resto: Resultado
+ * @param hilos: Hilos para las multiplicaciones grandes
+ */
+inline void dividir_grande(const NumeroGrande& u, const NumeroGrande& v,
+	NumeroGrande& cociente, NumeroGrande& resto, int hilos = 1) {
+	const long long GUARDA = 32;
+	long long n = bits_grande(v), k = bits_grande(u);
+	long long t = k - n + 1;  // Bits del cociente como mucho
+	if (v.size() < UMBRAL_DIVISION_NEWTON || t < 32 * (long long)UMBRAL_DIVISION_NEWTON) {
+		dividir_grande_knuth(u, v, cociente, resto);
+		return;
+	}
+
+	// w ~ v / 2^s con los W = t + GUARDA bits necesarios; u / v ~ u · inverso(w) / 2^(2W + s)
+	long long W = t + GUARDA, s = n - W;
+	NumeroGrande w = s >= 0 ? desplazar_derecha_grande(v, s) : desplazar_izquierda_grande(v, -s);
+	cociente = desplazar_derecha_grande(multiplicar_grande(u, inverso_grande(w, hilos), hilos), 2 * W + s);
+
+	// El cociente aproximado puede desviarse en unas pocas unidades
+	NumeroGrande producto = multiplicar_grande(cociente, v, hilos);
+	NumeroGrande uno = grande_desde(1);
+	while (comparar_grande(producto, u) > 0) {
+		restar_en_grande(cociente, uno);
+		restar_en_grande(producto, v);
+	}
+	resto = u;
+	restar_en_grande(resto, producto);
+	while (comparar_grande(resto, v) >= 0) {
+		sumar_en_grande(cociente, uno);
+		restar_en_grande(resto, v);
+	}
+}
+
+inline NumeroGrande dividir_grande(const NumeroGrande& u, const NumeroGrande& v, int hilos = 1) {
+	NumeroGrande cociente, resto;
+	dividir_grande(u, v, cociente, resto, hilos);
+	return cociente;
+}
+
+/**
+ * Inversa de la raíz cuadrada en coma fija: aproxima 2^bits / sqrt(a), salvo
+ * unas pocas unidades
+ *
+ * Iteración de Newton y = y·(3 - a·y²) / 2, sin divisiones, partiendo de 40
+ * bits calculados en double y duplicando la precisión en cada paso.
+ */
+inline NumeroGrande inversa_raiz_grande(uint32_t a, long long bits, int hilos = 1) {
+	long long p = 40;
+	NumeroGrande y = grande_desde((unsigned long long)(ldexp(1.0, (int)p) / sqrt((double)a)));
+	bool ultimo = false;
+	while (!ultimo) {
+		long long siguiente = 2 * p - 8;
+		if (siguiente >= bits) {
+			siguiente = bits;
+			ultimo = true;
+		}
+		y = desplazar_izquierda_grande(y, siguiente - p);
+		p = siguiente;
+
+		// y·(3·2^2p - a·y²) / 2^(2p+1); con y cerca de 2^p/sqrt(a) el paréntesis es positivo
+		NumeroGrande e = desplazar_izquierda_grande(grande_desde(3), 2 * p);
+		restar_en_grande(e, multiplicar_pequeno_grande(multiplicar_grande(y, y, hilos), a));
+		y = desplazar_derecha_grande(multiplicar_grande(y, e, hilos), 2 * p + 1);
+	}
+	return y;
+}
+
+/**
+ * DIVISIÓN BINARIA DE LA SERIE DE CHUDNOVSKY
+ *
+ * Para el tramo de términos [a, b):
+ *   P(a, b) = p(a) ··· p(b-1),  Q(a, b) = q(a) ··· q(b-1)
+ *   T(a, b) = T(a, m)·Q(m, b) + P(a, m)·T(m, b)
+ * con p(k) = (6k-5)(2k-1)(6k-1), q(k) = k³·640320³/24 y
+ * t(k) = (-1)^k·p(k)·(13591409 + 545140134k) (p(0) = q(0) = 1).
+ * Solo T puede ser negativo; se guarda su signo aparte.
+ */
+struct TramoChudnovsky {
+	NumeroGrande P, Q, T;
+	bool T_negativo = false;
+};
+
+// a + b con signo (magnitudes y signos separados)
+inline void sumar_con_signo(const NumeroGrande& a, bool a_negativo, const NumeroGrande& b, bool b_negativo,
+	NumeroGrande& r, bool& r_negativo) {
+	if (a_negativo == b_negativo) {
+		r = sumar_grande(a, b);
+		r_negativo = a_negativo;
+	}
+	else if (comparar_grande(a, b) >= 0) {
+		r = a;
+		restar_en_grande(r, b);
+		r_negativo = a_negativo;
+	}
+	else {
+		r = b;
+		restar_en_grande(r, a);
+		r_negativo = b_negativo;
+	}
+	if (r.empty()) r_negativo = false;
+}
+
+/**
+ * Combina dos tramos consecutivos: izq pasa a ser [a, c) a partir de [a, b) y [b, c)
+ *
+ * @param hilos: Si es mayor que 1, los cuatro productos se calculan a la vez
+ * @param necesita_P: En la combinación final P no se usa y se puede omitir
+ */
+inline void combinar_tramos(TramoChudnovsky& izq, const TramoChudnovsky& der, int hilos, bool necesita_P) {
+	NumeroGrande P, Q, TQ, PT;
+#pragma omp parallel sections if(hilos > 1) num_threads(hilos < 4 ? hilos : 4)
+	{
+#pragma omp section
+		{ TQ = multiplicar_grande(izq.T, der.Q); }
+#pragma omp section
+		{ PT = multiplicar_grande(izq.P, der.T); }
+#pragma omp section
+		{ Q = multiplicar_grande(izq.Q, der.Q); }
+#pragma omp section
+		{ if (necesita_P) P = multiplicar_grande(izq.P, der.P); }
+	}
+	NumeroGrande T;
+	bool T_negativo;
+	sumar_con_signo(TQ, izq.T_negativo, PT, der.T_negativo, T, T_negativo);
+	izq.P.swap(P);
+	izq.Q.swap(Q);
+	izq.T.swap(T);
+	izq.T_negativo = T_negativo;
+}
+
+// Tramo [a, b) calculado en el hilo llamante
+inline TramoChudnovsky dividir_tramo(long long a, long long b) {
+	TramoChudnovsky r;
+	if (b <= a) {
+		// Tramo vacío: elemento neutro de la combinación
+		r.P = r.Q = grande_desde(1);
+		return r;
+	}
+	if (b - a == 1) {
+		if (a == 0) {
+			r.P = r.Q = grande_desde(1);
+		}
+		else {
+			r.P = multiplicar_pequeno_grande(multiplicar_pequeno_grande(grande_desde(6 * a - 5),
+				(uint32_t)(2 * a - 1)), (uint32_t)(6 * a - 1));
+			// q(a) = a³ · 640320 · 640320 · 26680 (640320³ / 24)
+			r.Q = grande_desde((unsigned long long)a * a);
+			r.Q = multiplicar_pequeno_grande(r.Q, (uint32_t)a);
+			r.Q = multiplicar_pequeno_grande(r.Q, 640320u);
+			r.Q = multiplicar_pequeno_grande(r.Q, 640320u);
+			r.Q = multiplicar_pequeno_grande(r.Q, 26680u);
+		}
+		// t(a) = p(a) · (13591409 + 545140134a)
+		r.T = multiplicar_grande(r.P, grande_desde(13591409ULL + 545140134ULL * (unsigned long long)a));
+		r.T_negativo = (a % 2) == 1;
+		return r;
+	}
+	long long m = (a + b) / 2;
+	r = dividir_tramo(a, m);
+	TramoChudnovsky der = dividir_tramo(m, b);
+	combinar_tramos(r, der, 1, true);
+	return r;
+}
+
+// Valor de π en coma fija y su desglose en dos double
+struct ValorPi {
+	NumeroGrande fijo;        // floor(π · 2^bits_fraccion) (salvo las últimas cifras de guarda)
+	long long bits_fraccion;
+	double alto;              // π redondeado a double
+	double bajo;              // π - alto, también en double (π ≈ alto + bajo con ~106 bits)
+	double tiempo_serie_s;    // División binaria (parte paralela)
+	double tiempo_final_s;    // Raíz cuadrada y división final (paralelas solo en el primer nivel de Karatsuba)
+};
+
+// Valor aproximado de a · 2^exponente a partir de sus 64 bits altos
+inline double a_double_grande(const NumeroGrande& a, long long exponente) {
+	long long bits = bits_grande(a);
+	if (bits == 0) return 0.0;
+	long long descartar = bits > 64 ? bits - 64 : 0;
+	NumeroGrande alto = desplazar_derecha_grande(a, descartar);
+	uint64_t v = alto[0] | (alto.size() > 1 ? (uint64_t)alto[1] << 32 : 0);
+	return ldexp((double)v, (int)(descartar + exponente));
+}
+
+/**
+ * Calcula π con al menos 'cifras' cifras decimales correctas
+ *
+ * @param cifras: Cifras decimales pedidas
+ * @param hilos: Hilos para la división binaria
+ */
+inline ValorPi calcular_pi_chudnovsky(long long cifras, int hilos) {
+	ValorPi resultado;
+	const long long GUARDA = 64;
+	resultado.bits_fraccion = (long long)ceil(cifras * 3.3219280948873623) + GUARDA;
+	long long terminos = (long long)(cifras / 14.181647462725477) + 2;
+
+	// Tramos independientes en paralelo (potencia de 2, varios por hilo para equilibrar)
+	double inicio = omp_get_wtime();
+	int tramos = 1;
+	while (hilos > 1 && tramos < 4 * hilos) tramos *= 2;
+	std::vector<TramoChudnovsky> partes(tramos);
+	int k;
+#pragma omp parallel for schedule(dynamic, 1) num_threads(hilos)
+	for (k = 0; k < tramos; ++k) {
+		partes[k] = dividir_tramo(terminos * k / tramos, terminos * (k + 1) / tramos);
+	}
+
+	// Combinar por niveles: pares en paralelo mientras haya al menos uno por hilo;
+	// después, cada combinación reparte sus multiplicaciones entre los hilos
+	while (partes.size() > 1) {
+		int pares = (int)partes.size() / 2;
+		bool ultimo = pares == 1;
+		if (pares >= hilos) {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(hilos)
+			for (k = 0; k < pares; ++k) {
+				combinar_tramos(partes[2 * k], partes[2 * k + 1], 1, !ultimo);
+			}
+		}
+		else {
+			for (k = 0; k < pares; ++k) {
+				combinar_tramos(partes[2 * k], partes[2 * k + 1], hilos, !ultimo);
+			}
+		}
+		for (k = 0; k < pares; ++k) {
+			if (k > 0) partes[k] = std::move(partes[2 * k]);
+		}
+		partes.resize(pares);
+	}
+	resultado.tiempo_serie_s = omp_get_wtime() - inicio;
+
+	// π · 2^B = 426880 · sqrt(10005) · 2^B · Q / T, con sqrt(10005) = 10005 / sqrt(10005)
+	inicio = omp_get_wtime();
+	const long long B = resultado.bits_fraccion;
+	NumeroGrande raiz = multiplicar_pequeno_grande(inversa_raiz_grande(10005, B, hilos), 10005);
+	// Q y T tienen muchos más bits que los pedidos: para el cociente basta con sus bits altos
+	long long sobrantes = bits_grande(partes[0].T) - (B + GUARDA);
+	if (sobrantes > 0) {
+		partes[0].Q = desplazar_derecha_grande(partes[0].Q, sobrantes);
+		partes[0].T = desplazar_derecha_grande(partes[0].T, sobrantes);
+	}
+	NumeroGrande numerador = multiplicar_grande(multiplicar_pequeno_grande(partes[0].Q, 426880u), raiz, hilos);
+	resultado.fijo = dividir_grande(numerador, partes[0].T, hilos);
+	resultado.tiempo_final_s = omp_get_wtime() - inicio;
+
+	// Desglose en dos double: los 53 bits altos y lo que queda por debajo de ellos
+	long long bits = bits_grande(resultado.fijo);
+	long long descartar = bits - 53;
+	NumeroGrande alto_fijo = desplazar_izquierda_grande(desplazar_derecha_grande(resultado.fijo, descartar), descartar);
+	resultado.alto = a_double_grande(alto_fijo, -B);
+	NumeroGrande resto = resultado.fijo;
+	restar_en_grande(resto, alto_fijo);
+	resultado.bajo = a_double_grande(resto, -B);
+	return resultado;
+}
+
+/**
+ * Primeras cifras decimales de π ("3.14159...") a partir del valor en coma fija
+ *
+ * @param cuantas: Cifras tras la coma (no más de las calculadas)
+ */
+inline std::string cifras_pi(const ValorPi& valor, int cuantas) {
+	// floor(π · 10^cuantas) = (fijo · 10^cuantas) >> B
+	NumeroGrande x = valor.fijo;
+	for (int i = 0; i < cuantas; ++i) x = multiplicar_pequeno_grande(x, 10);
+	x = desplazar_derecha_grande(x, valor.bits_fraccion);
+	std::string cifras;
+	while (!x.empty()) {
+		uint32_t resto;
+		x = dividir_pequeno_grande(x, 10, resto);
+		cifras.insert(cifras.begin(), (char)('0' + resto));
+	}
+	return cifras.substr(0, 1) + "." + cifras.substr(1);
+}
+
+/**
+ * Valor de referencia para las columnas de error: π con 40 cifras, calculado
+ * una sola vez (la primera llamada) en el hilo llamante
+ */
+inline const ValorPi& referencia_pi() {
+	static const ValorPi valor = calcular_pi_chudnovsky(40, 1);
+	return valor;
+}
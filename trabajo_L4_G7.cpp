@@ -26,26 +26,203 @@
  * En esta implementación:
  *   - Versión secuencial: Usa rand()/RAND_MAX (generador simple de C)
  *   - Versión paralela: Usa std::mt19937 (Mersenne Twister, alta calidad)
- *     con semillas únicas para cada hilo
+ *     con semillas únicas para cada bloque de muestras
+ *
+ * BLOQUES Y CHECKPOINTS:
+ * ---------------------
+ * La versión paralela divide las muestras en bloques de tamaño fijo. Cada
+ * bloque siembra su propio generador a partir de (semilla, índice de bloque),
+ * así que el resultado solo depende de la semilla: no cambia con el número de
+ * hilos ni con el orden en que se procesan los bloques. Esto permite guardar
+ * el progreso periódicamente (checkpoint) y reanudar una ejecución larga
+ * obteniendo exactamente el mismo valor que sin interrupción.
  */
 
 #include <stdio.h>
 #include <math.h>
 #include <omp.h>      // Biblioteca OpenMP para paralelización
 #include <stdlib.h>
+#include <errno.h>    // ERANGE de strtoll/strtoull/strtod
 #include <time.h>
 #include <fstream>    // Para manejo de archivos
 #include <random>     // Para generadores aleatorios de alta calidad (C++11)
+#include <string>
+#include <string.h>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>   // __cpuid, para identificar el modelo de CPU en el autotuner
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#include <filesystem> // Para el renombrado atómico de los checkpoints (C++17)
+
+#include "nucleos_montecarlo.h"  // Bucle de muestreo y tabla de variantes
+#include "pi_referencia.h"       // Valor de referencia de π (Chudnovsky)
+#include "integrador_montecarlo.h"  // integrar(f, dominio, samples, politica)
+#include "expresion_integrando.h"   // Integrandos escritos como texto en tiempo de ejecución
+#include "valoracion_opciones.h"    // Opciones europeas y asiáticas (Black-Scholes)
+
+// En el modo con presupuesto de tiempo cada hilo comprueba el límite cada
+// este número de muestras (del orden de decenas de microsegundos de trabajo).
+// Cada unidad siembra su propio generador, así que con menos muestras la
+// siembra de mt19937 se lleva una parte apreciable del tiempo.
+const long long MUESTRAS_POR_COMPROBACION = 4096;
+
+// Tipos de reparto de bloques entre hilos (cláusula schedule de OpenMP)
+enum Planificacion { PLAN_STATIC, PLAN_DYNAMIC, PLAN_GUIDED, NUM_PLANIFICACIONES };
+const char* const NOMBRES_PLANIFICACION[] = { "static", "dynamic", "guided" };
 
  // Estructura para almacenar los resultados de ambos métodos (secuencial y paralelo)
 struct ResultadoMontecarlo {
-	double pi;                // Valor calculado de π
+	double pi;                // Valor calculado de π (precio en la valoración de opciones)
 	double tiempo_segundos;   // Tiempo de ejecución en segundos
 	double tiempo_ms;         // Tiempo de ejecución en milisegundos
 	double tiempo_us;         // Tiempo de ejecución en microsegundos
 	long long samples;        // Número de muestras utilizadas
 	bool es_paralelo;         // Indica si es versión paralela o secuencial
+	const char* metodo;       // Nombre del método en el CSV ("Secuencial", "OpenMP", ...)
 	int num_hilos;            // Número de hilos usados (1 para secuencial)
+	double suma;                 // Suma del estimador (puntos dentro del círculo en acierto-fallo)
+	unsigned long long semilla;  // Semilla base (solo versión paralela)
+	bool cancelado;              // La ejecución se detuvo antes de completar todas las muestras
+	int bits_coordenada;         // Bits aleatorios de cada coordenada (resolución de la rejilla)
+	double error_absoluto;       // |pi - π| frente al valor de referencia
+	double error_relativo;       // error_absoluto / π
+	double z;                    // (pi - π) / error estándar; NaN si no hay error estándar (retícula)
+	// Intervalos de confianza al 95 % a partir de las sumas por lotes (NaN si no se calculan)
+	double ic_bootstrap_inferior = std::numeric_limits<double>::quiet_NaN();
+	double ic_bootstrap_superior = std::numeric_limits<double>::quiet_NaN();
+	double ic_lotes_inferior = std::numeric_limits<double>::quiet_NaN();
+	double ic_lotes_superior = std::numeric_limits<double>::quiet_NaN();
+};
+
+/**
+ * Rellena las columnas de error comparando con π calculado por Chudnovsky. El
+ * valor de referencia se guarda como alto + bajo (dos double), así que la resta
+ * no pierde las cifras bajas aunque la estimación sea muy precisa.
+ *
+ * @param error_estandar: Desviación típica teórica de la estimación (0 si no aplica)
+ */
+static void calcular_errores(ResultadoMontecarlo& r, double error_estandar) {
+	const ValorPi& referencia = referencia_pi();
+	double diferencia = (r.pi - referencia.alto) - referencia.bajo;
+	r.error_absoluto = fabs(diferencia);
+	r.error_relativo = r.error_absoluto / referencia.alto;
+	r.z = error_estandar > 0 ? diferencia / error_estandar : std::numeric_limits<double>::quiet_NaN();
+}
+
+/**
+ * Igual que la anterior, pero frente a un valor de referencia cualquiera (p. ej.
+ * el precio exacto de una opción)
+ */
+static void calcular_errores(ResultadoMontecarlo& r, double error_estandar, double referencia) {
+	double diferencia = r.pi - referencia;
+	r.error_absoluto = fabs(diferencia);
+	r.error_relativo = r.error_absoluto / fabs(referencia);
+	r.z = error_estandar > 0 ? diferencia / error_estandar : std::numeric_limits<double>::quiet_NaN();
+}
+
+static void imprimir_error(const ResultadoMontecarlo& r) {
+	if (r.z == r.z) {
+		printf("Error = %.3e (relativo %.3e, z = %.2f)\n", r.error_absoluto, r.error_relativo, r.z);
+	}
+	else {
+		printf("Error = %.3e (relativo %.3e)\n", r.error_absoluto, r.error_relativo);
+	}
+}
+
+// Estado persistido en un checkpoint. Los bloques se completan siempre como un
+// prefijo contiguo, así que basta con saber cuántos van hechos: la posición de
+// cada generador queda determinada por (semilla, índice de bloque).
+struct EstadoCheckpoint {
+	unsigned long long semilla;
+	long long samples;
+	long long muestras_por_bloque;
+	long long bloques_completados;
+	double suma;                   // Suma del estimador en los bloques completados
+	int generador;                 // Núcleo con el que se empezó
+	int precision;
+	int estimador;
+	int variante;
+};
+
+// Control cooperativo de una ejecución paralela. La cancelación se comprueba
+// al empezar cada bloque, así que una ejecución cancelada se detiene en el tiempo
+// que tarda un bloque. El aviso de progreso lo hace solo el hilo maestro (hilo 0),
+// fuera del bucle interno de muestras, cada 'bloques_entre_avisos' bloques.
+struct ControlEjecucion {
+	std::atomic<bool> cancelado{ false };   // Puede activarse desde cualquier hilo
+	void (*progreso)(long long bloques_hechos, long long bloques_totales, void* datos) = nullptr;
+	void* datos_progreso = nullptr;
+	long long bloques_entre_avisos = 1024;
+
+	// Estado interno, lo mantiene el motor paralelo
+	std::atomic<long long> bloques_hechos{ 0 };
+	long long bloques_totales = 0;
+	long long siguiente_aviso = 0;
+};
+
+// Sumas del estimador en LOTES_INTERVALO lotes de muestras consecutivas de
+// [desde, hasta), de tamaños iguales (±1). El motor paralelo no deja que una
+// llamada al núcleo cruce el borde de un lote, así que cada lote recibe
+// exactamente sus muestras aunque haya menos bloques que lotes.
+const int LOTES_INTERVALO = 32;
+struct SumasLotes {
+	long long desde = 0;
+	long long hasta = 0;
+	double suma[LOTES_INTERVALO] = {};
+	long long muestras[LOTES_INTERVALO] = {};
+
+	// Primera muestra del lote k (inicio(LOTES_INTERVALO) == hasta)
+	long long inicio(int k) const { return desde + (hasta - desde) * k / LOTES_INTERVALO; }
+	// Lote de la muestra i (el mayor k con inicio(k) <= i)
+	int lote(long long i) const { return (int)(((i - desde + 1) * LOTES_INTERVALO - 1) / (hasta - desde)); }
+};
+
+// Opciones de la versión paralela. Los valores por defecto reproducen el
+// comportamiento original: 8 hilos, acierto-fallo con Mersenne Twister y double, semilla
+// aleatoria y sin checkpoints. El autotuner puede sustituir la configuración
+// del núcleo por la mejor medida en esta máquina (ver cargar_autotune).
+struct OpcionesParalelo {
+	int num_hilos = 8;
+	int planificacion = PLAN_DYNAMIC;      // Reparto de bloques entre hilos
+	int bloques_por_chunk = 1;             // Unidades (bloques o trozos) que toma un hilo de cada vez
+	int generador = GEN_MT19937;
+	int precision = PREC_DOUBLE;
+	int estimador = EST_ACIERTOS;
+	int desenrollado = 1;                  // 1, 2 o 4 muestras por iteración (variante escalar)
+	int variante = VAR_ESCALAR;            // Bucle escalar o tubería con búfer (ver Variante)
+	int palabras_bufer = 1024;             // Tamaño del búfer (variantes con búfer)
+	int flujos_ilp = 4;                    // Generadores intercalados por hilo (variante ilp)
+	int dimension_bola = 0;                // 0: π en el cuarto de círculo; 2..32: volumen de la bola unidad
+	int experimento_buffon = -1;           // -1: ninguno; BUFFON_AGUJA o BUFFON_LAPLACE
+	int metodo_normal = NORMAL_BOX_MULLER; // Normales de la valoración de opciones
+	bool intervalos = false;               // Intervalos de confianza bootstrap y por lotes
+	SumasLotes* lotes = nullptr;           // Si no es nullptr, acumula las sumas por lotes
+	bool semilla_fija = false;             // Si es false se usa std::random_device
+	unsigned long long semilla = 0;
+	const char* archivo_checkpoint = nullptr; // nullptr = no guardar progreso
+	double intervalo_checkpoint_s = 60.0;  // Segundos mínimos entre checkpoints
+	const EstadoCheckpoint* reanudar_desde = nullptr; // Estado previo a continuar
+	ControlEjecucion* control = nullptr;   // Cancelación y progreso (opcional)
+};
+
+// Registro persistente de una ejecución paralela terminada. La semilla basta
+// para regenerar cualquier rango de muestras, así que una estimación de N
+// muestras puede ampliarse a M calculando solo las muestras [N, M).
+struct RegistroEjecucion {
+	unsigned long long semilla;
+	long long samples;
+	long long muestras_por_bloque;
+	double suma;
+	int generador;
+	int precision;
+	int estimador;
+	int variante;
 };
 
 /**
@@ -56,33 +233,28 @@ struct ResultadoMontecarlo {
  */
 ResultadoMontecarlo montecarlo_secuencial(long long samples) {
 	unsigned long long count = 0;  // Contador de puntos dentro del círculo
-	unsigned long long i;
-	double x, y;                   // Coordenadas del punto aleatorio
+	MotorRand gen;                 // Generador simple de C (rand)
 	double inicio, final, total = 0;
 	ResultadoMontecarlo resultado;
 
 	// Inicializar datos del resultado
 	resultado.samples = samples;
 	resultado.es_paralelo = false;
+	resultado.metodo = "Secuencial";
 	resultado.num_hilos = 1;
+	resultado.semilla = 0;
+	resultado.cancelado = false;
+	resultado.bits_coordenada = 0;
+	for (long long v = RAND_MAX; v > 0; v >>= 1) resultado.bits_coordenada++;
 
 	// Iniciar cronómetro
 	inicio = omp_get_wtime();
 
-	// Bucle principal - genera 'samples' puntos aleatorios
-	for (i = 0; i < samples; ++i) {
-		// Generar punto aleatorio en el cuadrante [0,1]×[0,1]
-		// rand() genera enteros entre 0 y RAND_MAX
-		// La división normaliza a valores entre 0 y 1
-		x = ((double)rand()) / ((double)RAND_MAX);
-		y = ((double)rand()) / ((double)RAND_MAX);
-
-		// Comprobar si el punto está dentro del círculo unitario
-		// Un punto (x,y) está dentro del círculo si x² + y² ≤ 1
-		if (x * x + y * y <= 1.0) {
-			++count;  // Incrementar contador si está dentro
-		}
-	}
+	// Bucle principal - genera 'samples' puntos aleatorios con el bucle común
+	// de nucleos_montecarlo.h:
+	//   - Cada coordenada es rand()/RAND_MAX, un valor entre 0 y 1
+	//   - Un punto (x,y) está dentro del círculo si x² + y² ≤ 1
+	count = sumar_muestras<MotorRand, double, EstimadorAciertos, 1>(gen, samples);
 
 	// Detener cronómetro y calcular tiempo total
 	final = omp_get_wtime();
@@ -91,14 +263,17 @@ ResultadoMontecarlo montecarlo_secuencial(long long samples) {
 	// Calcular π: 4 veces la proporción de puntos dentro del círculo
 	// Multiplicamos por 4 porque solo estamos considerando un cuadrante
 	resultado.pi = 4.0 * count / samples;
+	resultado.suma = (double)count;
 	resultado.tiempo_segundos = total;
 	resultado.tiempo_ms = total * 1e3;  // convertir a milisegundos
 	resultado.tiempo_us = total * 1e6;  // convertir a microsegundos
+	calcular_errores(resultado, EstimadorAciertos::error_estandar(resultado.pi, samples));
 
 	// Mostrar resultados por consola
 	printf("----------------OpenMP MonterCarlo Sin Paralelizar----------------\n");
 	printf("Numero de Samples = %lld\n", samples);
 	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
 	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
 	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
 	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
@@ -107,92 +282,827 @@ ResultadoMontecarlo montecarlo_secuencial(long long samples) {
 	return resultado;
 }
 
+// Parámetro de ajuste pedido para la variante (desenrollado, tamaño del búfer o flujos)
+static int parametro_pedido(const OpcionesParalelo& opciones) {
+	if (opciones.variante == VAR_ESCALAR) return opciones.desenrollado;
+	if (opciones.variante == VAR_ILP) return opciones.flujos_ilp;
+	return opciones.palabras_bufer;
+}
+
+static const EntradaNucleo* buscar_nucleo_exacto(const OpcionesParalelo& opciones) {
+	return buscar_nucleo(opciones.generador, opciones.precision, opciones.estimador,
+		opciones.variante, parametro_pedido(opciones));
+}
+
+/**
+ * Devuelve la entrada de la tabla de núcleos para la configuración pedida. El
+ * parámetro de ajuste depende de la variante (desenrollado, tamaño del búfer o
+ * número de flujos); si el pedido no está instanciado se usa el primero de la
+ * variante, y si la variante no existe para ese generador (dividido-64 con
+ * mt19937), el bucle escalar. En los dos casos se avisa por consola.
+ */
+const EntradaNucleo* seleccionar_nucleo(const OpcionesParalelo& opciones) {
+	const EntradaNucleo* nucleo = buscar_nucleo_exacto(opciones);
+	if (nucleo != nullptr) {
+		return nucleo;
+	}
+	int parametro = TAMANOS_BUFER[0];
+	if (opciones.variante == VAR_ESCALAR) parametro = DESENROLLADOS[0];
+	if (opciones.variante == VAR_ILP) parametro = FLUJOS_ILP[0];
+	nucleo = buscar_nucleo(opciones.generador, opciones.precision, opciones.estimador,
+		opciones.variante, parametro);
+	if (nucleo == nullptr) {
+		nucleo = buscar_nucleo(opciones.generador, opciones.precision, opciones.estimador,
+			VAR_ESCALAR, DESENROLLADOS[0]);
+	}
+
+	// La línea de comandos ya rechaza los parámetros que no existen, así que aquí
+	// solo se llega con configuraciones del autotuner o de archivos guardados.
+	// Se avisa una vez por configuración (se llama varias veces por ejecución)
+	static std::string ultimo_aviso;
+	std::string aviso = std::string(NOMBRES_ESTIMADOR[opciones.estimador]) + "/" +
+		NOMBRES_GENERADOR[opciones.generador] + "/" + NOMBRES_PRECISION[opciones.precision] + " " +
+		NOMBRES_VARIANTE[opciones.variante] + " con parametro " + std::to_string(parametro_pedido(opciones));
+	if (aviso != ultimo_aviso) {
+		printf("Aviso: No hay nucleo %s; se usa %s con parametro %d\n", aviso.c_str(),
+			NOMBRES_VARIANTE[nucleo->variante], nucleo->parametro);
+		ultimo_aviso = aviso;
+	}
+	return nucleo;
+}
+
+// Función de bloque que usa el motor paralelo: la del núcleo de π o, si se pide
+// una dimensión o un experimento de Buffon, la suya con el generador elegido
+static FuncionBloque funcion_bloque(const OpcionesParalelo& opciones) {
+	if (opciones.experimento_buffon >= 0) {
+		return buscar_buffon(opciones.generador, opciones.experimento_buffon)->sumar;
+	}
+	if (opciones.dimension_bola > 0) {
+		return buscar_bola(opciones.generador, opciones.dimension_bola)->sumar;
+	}
+	return seleccionar_nucleo(opciones)->sumar;
+}
+
+// Texto de la variante del núcleo y su parámetro, para los mensajes por consola
+static std::string describir_variante(const OpcionesParalelo& opciones) {
+	const EntradaNucleo* nucleo = seleccionar_nucleo(opciones);
+	if (nucleo->variante == VAR_ESCALAR) {
+		return "desenrollado x" + std::to_string(nucleo->parametro);
+	}
+	if (nucleo->variante == VAR_ILP) {
+		return "ilp, K=" + std::to_string(nucleo->parametro) + " flujos";
+	}
+	std::string bufer = "bufer de " + std::to_string(nucleo->parametro) + " palabras";
+	if (nucleo->variante == VAR_BUFER) {
+		return bufer;
+	}
+	return std::string(NOMBRES_VARIANTE[nucleo->variante]) + ", " + bufer;
+}
+
+/**
+ * Semilla base de una ejecución: la indicada por el usuario o una de alta
+ * calidad obtenida de std::random_device (entropía del hardware si está disponible)
+ */
+static unsigned long long obtener_semilla(const OpcionesParalelo& opciones) {
+	if (opciones.semilla_fija) {
+		return opciones.semilla;
+	}
+	std::random_device rd;
+	return (static_cast<unsigned long long>(rd()) << 32) | rd();
+}
+
+/**
+ * REPARTO EN TROZOS DE BLOQUE
+ *
+ * El bloque es la unidad de siembra (y de los checkpoints), pero no tiene por
+ * qué ser la de reparto: con menos bloques que hilos, cada bloque se parte en
+ * trozos que se reparten por separado. Cada trozo siembra el generador de su
+ * bloque y salta hasta su primera muestra, así que la secuencia de cada muestra
+ * no cambia (ni el resultado en acierto-fallo). El salto es O(1) en los
+ * generadores basados en contador (aes-ctr) y lineal en los demás, por lo que
+ * partir bloques sirve sobre todo para que los hilos no se queden sin trabajo
+ * en las ejecuciones cortas, no para acelerar los generadores con estado.
+ */
+const long long MUESTRAS_MIN_TROZO = 1024;  // No se parte por debajo de esto: la siembra domina
+
+/**
+ * Trozos en que se parte cada bloque de [desde, hasta) para tener al menos
+ * 'unidades' unidades de reparto (sin bajar de MUESTRAS_MIN_TROZO por trozo)
+ */
+static long long trozos_por_bloque(long long desde, long long hasta, long long unidades) {
+	if (hasta <= desde) {
+		return 1;
+	}
+	long long bloques = (hasta - 1) / MUESTRAS_POR_BLOQUE - desde / MUESTRAS_POR_BLOQUE + 1;
+	long long trozos = (unidades + bloques - 1) / bloques;
+	long long maximo = (hasta - desde) / bloques / MUESTRAS_MIN_TROZO;
+	if (trozos > maximo) trozos = maximo;
+	return trozos > 1 ? trozos : 1;
+}
+
+/**
+ * Hilos que reciben trabajo al repartir [desde, hasta) con contar_rango_paralelo:
+ * el mínimo entre los pedidos y las unidades de reparto. Es el valor que se
+ * muestra y se guarda en el CSV
+ */
+static int hilos_efectivos(long long desde, long long hasta, int num_hilos) {
+	if (hasta <= desde) {
+		return 1;
+	}
+	long long bloques = (hasta - 1) / MUESTRAS_POR_BLOQUE - desde / MUESTRAS_POR_BLOQUE + 1;
+	long long unidades = bloques * trozos_por_bloque(desde, hasta, num_hilos);
+	return unidades < num_hilos ? (int)unidades : num_hilos;
+}
+
+/**
+ * Llama al núcleo en [desde, hasta) de un bloque partiendo el rango en los
+ * bordes de los lotes, y acumula cada parte en su lote (varios hilos a la vez)
+ */
+static double contar_en_lotes(SumasLotes& lotes, FuncionBloque contar_bloque, unsigned long long semilla,
+	long long bloque, long long desde, long long hasta) {
+	double total = 0.0;
+	while (desde < hasta) {
+		int k = lotes.lote(desde);
+		long long fin = lotes.inicio(k + 1) < hasta ? lotes.inicio(k + 1) : hasta;
+		double parcial = contar_bloque(semilla, bloque, desde, fin);
+#pragma omp atomic
+		lotes.suma[k] += parcial;
+#pragma omp atomic
+		lotes.muestras[k] += fin - desde;
+		total += parcial;
+		desde = fin;
+	}
+	return total;
+}
+
+/**
+ * Suma en paralelo las contribuciones del estimador para las muestras [desde, hasta)
+ *
+ * @param semilla: Semilla base de la ejecución
+ * @param desde, hasta: Rango global de muestras
+ * @param opciones: Hilos, reparto, núcleo de conteo y control (puede no haber control)
+ * @param hechas: Devuelve las muestras realmente procesadas (menos que hasta - desde
+ *                si se canceló la ejecución)
+ * @return Suma del estimador en las muestras procesadas (aciertos en acierto-fallo)
+ */
+double contar_rango_paralelo(unsigned long long semilla, long long desde,
+	long long hasta, const OpcionesParalelo& opciones, long long& hechas) {
+	double count = 0;              // Suma global (compartida entre hilos)
+	long long procesadas = 0;
+	long long u;
+
+	hechas = 0;
+	if (hasta <= desde) {
+		return 0;
+	}
+	long long primer_bloque = desde / MUESTRAS_POR_BLOQUE;
+	long long ultimo_bloque = (hasta - 1) / MUESTRAS_POR_BLOQUE;
+	FuncionBloque contar_bloque = funcion_bloque(opciones);
+	ControlEjecucion* control = opciones.control;
+	int num_hilos = opciones.num_hilos;
+	int chunk = opciones.bloques_por_chunk;
+
+	// Unidades de reparto: cada bloque en 'trozos' trozos consecutivos (1 si hay
+	// bloques de sobra para todos los hilos)
+	const long long trozos = trozos_por_bloque(desde, hasta, num_hilos);
+	const long long unidades = (ultimo_bloque - primer_bloque + 1) * trozos;
+
+	// Trabajo de una unidad, común a los tres tipos de reparto
+	auto procesar_unidad = [&](long long unidad, double& suma, long long& muestras) {
+		// Un bucle 'omp for' no admite break: tras una cancelación las unidades
+		// restantes se saltan sin trabajo
+		if (control != nullptr && control->cancelado.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		// Intersección del bloque con el rango pedido, y trozo de esa intersección
+		long long bloque = primer_bloque + unidad / trozos;
+		long long trozo = unidad % trozos;
+		long long inicio_bloque = bloque * MUESTRAS_POR_BLOQUE;
+		long long fin_bloque = inicio_bloque + MUESTRAS_POR_BLOQUE;
+		long long d = inicio_bloque > desde ? inicio_bloque : desde;
+		long long h = fin_bloque < hasta ? fin_bloque : hasta;
+		long long inicio_trozo = d + (h - d) * trozo / trozos;
+		long long fin_trozo = d + (h - d) * (trozo + 1) / trozos;
+		double parcial = opciones.lotes == nullptr ? contar_bloque(semilla, bloque, inicio_trozo, fin_trozo)
+			: contar_en_lotes(*opciones.lotes, contar_bloque, semilla, bloque, inicio_trozo, fin_trozo);
+		suma += parcial;
+		muestras += fin_trozo - inicio_trozo;
+
+		// El progreso cuenta bloques: se avisa con el último trozo de cada uno
+		if (control != nullptr && trozo == trozos - 1) {
+			long long total_hechos = control->bloques_hechos.fetch_add(1, std::memory_order_relaxed) + 1;
+			if (control->progreso != nullptr && omp_get_thread_num() == 0 &&
+				total_hechos >= control->siguiente_aviso) {
+				control->progreso(total_hechos, control->bloques_totales, control->datos_progreso);
+				control->siguiente_aviso = total_hechos + control->bloques_entre_avisos;
+			}
+		}
+	};
+
+	// Repartir las unidades entre los hilos. El tipo de reparto va en la cláusula
+	// schedule, que no admite una variable, así que hay un bucle por tipo.
+	// La cláusula reduction(+:count) combina automáticamente las sumas parciales.
+	// Con acierto-fallo las sumas son enteras y exactas; con estimadores reales el
+	// orden de la reducción puede cambiar los últimos bits según el número de hilos
+	switch (opciones.planificacion) {
+	case PLAN_STATIC:
+#pragma omp parallel for schedule(static, chunk) reduction(+:count,procesadas) num_threads(num_hilos)
+		for (u = 0; u < unidades; ++u) {
+			procesar_unidad(u, count, procesadas);
+		}
+		break;
+	case PLAN_GUIDED:
+#pragma omp parallel for schedule(guided, chunk) reduction(+:count,procesadas) num_threads(num_hilos)
+		for (u = 0; u < unidades; ++u) {
+			procesar_unidad(u, count, procesadas);
+		}
+		break;
+	default:
+		// Con schedule(dynamic) un hilo que termina antes toma la siguiente unidad libre
+#pragma omp parallel for schedule(dynamic, chunk) reduction(+:count,procesadas) num_threads(num_hilos)
+		for (u = 0; u < unidades; ++u) {
+			procesar_unidad(u, count, procesadas);
+		}
+		break;
+	}
+
+	hechas = procesadas;
+	return count;
+}
+
+/**
+ * Suma en el hilo llamante las contribuciones del estimador para las muestras
+ * [desde, hasta). Recorre los mismos bloques que contar_rango_paralelo y da el
+ * mismo resultado, pero sin abrir una región paralela.
+ */
+double contar_rango_secuencial(unsigned long long semilla, long long desde, long long hasta,
+	const OpcionesParalelo& opciones) {
+	double count = 0;
+	FuncionBloque contar_bloque = funcion_bloque(opciones);
+	for (long long b = desde / MUESTRAS_POR_BLOQUE; b * MUESTRAS_POR_BLOQUE < hasta; ++b) {
+		long long inicio_bloque = b * MUESTRAS_POR_BLOQUE;
+		long long fin_bloque = inicio_bloque + MUESTRAS_POR_BLOQUE;
+		count += contar_bloque(semilla, b, inicio_bloque > desde ? inicio_bloque : desde,
+			fin_bloque < hasta ? fin_bloque : hasta);
+	}
+	return count;
+}
+
+/**
+ * Versión sin control de cancelación ni progreso
+ */
+double contar_rango_paralelo(unsigned long long semilla, long long desde,
+	long long hasta, const OpcionesParalelo& opciones) {
+	OpcionesParalelo sin_control = opciones;
+	sin_control.control = nullptr;
+	long long hechas;
+	return contar_rango_paralelo(semilla, desde, hasta, sin_control, hechas);
+}
+
+/**
+ * Escribe un archivo de forma atómica
+ *
+ * Se escribe primero un archivo temporal y después se renombra sobre el
+ * definitivo, así una interrupción durante la escritura nunca deja el
+ * archivo a medias.
+ *
+ * @return true si el archivo quedó guardado
+ */
+bool escribir_archivo_atomico(const char* nombre_archivo, const std::string& contenido) {
+	std::string temporal = std::string(nombre_archivo) + ".tmp";
+	{
+		std::ofstream archivo(temporal);
+		if (!archivo.is_open()) {
+			printf("Error: No se pudo abrir el archivo %s para escritura\n", temporal.c_str());
+			return false;
+		}
+		archivo << contenido;
+		archivo.flush();
+		if (!archivo) {
+			printf("Error: Fallo al escribir el archivo %s\n", temporal.c_str());
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporal, nombre_archivo, ec);
+	if (ec) {
+		printf("Error: No se pudo renombrar %s a %s\n", temporal.c_str(), nombre_archivo);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Lee un archivo de estado con formato "cabecera versión" seguido de líneas
+ * "clave valor" (checkpoints y registros de ejecución)
+ *
+ * @return true si el archivo existe, la cabecera coincide y están todas las claves pedidas
+ */
+static bool leer_archivo_estado(const char* nombre_archivo, const char* cabecera, int version,
+	std::initializer_list<const char*> claves, std::map<std::string, std::string>& valores) {
+	std::ifstream archivo(nombre_archivo);
+	if (!archivo.is_open()) {
+		printf("Error: No se pudo abrir el archivo %s\n", nombre_archivo);
+		return false;
+	}
+
+	std::string clave, valor;
+	int version_archivo = 0;
+	archivo >> clave >> version_archivo;
+	if (clave != cabecera || version_archivo != version) {
+		printf("Error: %s no es un archivo '%s' valido\n", nombre_archivo, cabecera);
+		return false;
+	}
+
+	while (archivo >> clave >> valor) {
+		valores[clave] = valor;
+	}
+	for (const char* necesaria : claves) {
+		if (valores.find(necesaria) == valores.end()) {
+			printf("Error: Falta la clave '%s' en %s\n", necesaria, nombre_archivo);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Representación de un double que se relee sin pérdida
+static std::string formatear_exacto(double valor) {
+	char buffer[40];
+	snprintf(buffer, sizeof(buffer), "%.17g", valor);
+	return buffer;
+}
+
+// Lista de valores separados por comas, para los mensajes de error
+static std::string listar_valores(const int* valores, int cuantos) {
+	std::string lista;
+	for (int k = 0; k < cuantos; k++) {
+		lista += (k > 0 ? ", " : "") + std::to_string(valores[k]);
+	}
+	return lista;
+}
+
+// Índice de 'nombre' en una tabla de nombres, o -1 si no está
+static int buscar_nombre(const char* const* nombres, int cuantos, const std::string& nombre) {
+	for (int k = 0; k < cuantos; k++) {
+		if (nombre == nombres[k]) return k;
+	}
+	return -1;
+}
+
+/**
+ * Conversión estricta de los valores de los archivos de estado y de la línea de
+ * comandos: todo el texto tiene que ser el número, sin restos y dentro del
+ * rango del tipo
+ *
+ * @return false si el texto no es un número válido
+ */
+static bool leer_numero(const std::string& texto, long long& valor) {
+	char* fin = nullptr;
+	errno = 0;
+	valor = strtoll(texto.c_str(), &fin, 10);
+	return !texto.empty() && *fin == '\0' && errno != ERANGE;
+}
+
+static bool leer_numero(const std::string& texto, unsigned long long& valor) {
+	char* fin = nullptr;
+	errno = 0;
+	valor = strtoull(texto.c_str(), &fin, 10);
+	return !texto.empty() && texto[0] != '-' && *fin == '\0' && errno != ERANGE;
+}
+
+static bool leer_numero(const std::string& texto, int& valor) {
+	long long leido;
+	if (!leer_numero(texto, leido) || leido != (long long)(int)leido) {
+		return false;
+	}
+	valor = (int)leido;
+	return true;
+}
+
+static bool leer_numero(const std::string& texto, double& valor) {
+	char* fin = nullptr;
+	errno = 0;
+	valor = strtod(texto.c_str(), &fin);
+	return !texto.empty() && *fin == '\0' && errno != ERANGE && valor == valor;  // valor == valor descarta NaN
+}
+
+/**
+ * Guarda un checkpoint de forma atómica (ver escribir_archivo_atomico)
+ *
+ * @return true si el checkpoint quedó guardado
+ */
+bool guardar_checkpoint(const char* nombre_archivo, const EstadoCheckpoint& estado) {
+	std::string contenido = "montecarlo_checkpoint 3\n"
+		"generador " + std::string(NOMBRES_GENERADOR[estado.generador]) + "\n"
+		"precision " + NOMBRES_PRECISION[estado.precision] + "\n"
+		"estimador " + NOMBRES_ESTIMADOR[estado.estimador] + "\n"
+		"variante " + NOMBRES_VARIANTE[estado.variante] + "\n"
+		"semilla " + std::to_string(estado.semilla) + "\n"
+		"samples " + std::to_string(estado.samples) + "\n"
+		"muestras_por_bloque " + std::to_string(estado.muestras_por_bloque) + "\n"
+		"bloques_completados " + std::to_string(estado.bloques_completados) + "\n"
+		"suma " + formatear_exacto(estado.suma) + "\n";
+	return escribir_archivo_atomico(nombre_archivo, contenido);
+}
+
+/**
+ * Lee un checkpoint guardado con guardar_checkpoint
+ *
+ * @return true si el archivo existe, es válido y es compatible con esta versión
+ */
+bool cargar_checkpoint(const char* nombre_archivo, EstadoCheckpoint& estado) {
+	std::map<std::string, std::string> valores;
+	if (!leer_archivo_estado(nombre_archivo, "montecarlo_checkpoint", 3,
+		{ "generador", "precision", "estimador", "variante", "semilla", "samples", "muestras_por_bloque",
+		  "bloques_completados", "suma" },
+		valores)) {
+		return false;
+	}
+
+	if (!leer_numero(valores["semilla"], estado.semilla) || !leer_numero(valores["samples"], estado.samples) ||
+		!leer_numero(valores["muestras_por_bloque"], estado.muestras_por_bloque) ||
+		!leer_numero(valores["bloques_completados"], estado.bloques_completados) ||
+		!leer_numero(valores["suma"], estado.suma)) {
+		printf("Error: El checkpoint %s tiene valores que no son numeros validos\n", nombre_archivo);
+		return false;
+	}
+
+	estado.generador = buscar_nombre(NOMBRES_GENERADOR, NUM_GENERADORES, valores["generador"]);
+	estado.precision = buscar_nombre(NOMBRES_PRECISION, NUM_PRECISIONES, valores["precision"]);
+	estado.estimador = buscar_nombre(NOMBRES_ESTIMADOR, NUM_ESTIMADORES, valores["estimador"]);
+	estado.variante = buscar_nombre(NOMBRES_VARIANTE, NUM_VARIANTES, valores["variante"]);
+
+	if (estado.generador < 0 || estado.precision < 0 || estado.estimador < 0 || estado.variante < 0 ||
+		estado.muestras_por_bloque != MUESTRAS_POR_BLOQUE) {
+		printf("Error: El checkpoint %s es de otra configuracion\n", nombre_archivo);
+		return false;
+	}
+
+	// Cada muestra aporta entre 0 y 1 a la suma (acierto-fallo o sqrt(1 - x²))
+	if (estado.samples <= 0) {
+		printf("Error: El checkpoint %s tiene un numero de muestras no valido\n", nombre_archivo);
+		return false;
+	}
+	long long bloques = (estado.samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	if (estado.bloques_completados < 0 || estado.bloques_completados > bloques) {
+		printf("Error: El checkpoint %s tiene %lld bloques completados de %lld\n", nombre_archivo,
+			estado.bloques_completados, bloques);
+		return false;
+	}
+	long long hechas = estado.bloques_completados == bloques ? estado.samples
+		: estado.bloques_completados * MUESTRAS_POR_BLOQUE;
+	if (estado.suma < 0 || estado.suma > (double)hechas) {
+		printf("Error: La suma del checkpoint %s no es posible con %lld muestras\n", nombre_archivo, hechas);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Guarda el registro de una ejecución terminada de forma atómica
+ *
+ * @return true si el registro quedó guardado
+ */
+bool guardar_registro(const char* nombre_archivo, const RegistroEjecucion& registro) {
+	std::string contenido = "montecarlo_registro 3\n"
+		"generador " + std::string(NOMBRES_GENERADOR[registro.generador]) + "\n"
+		"precision " + NOMBRES_PRECISION[registro.precision] + "\n"
+		"estimador " + NOMBRES_ESTIMADOR[registro.estimador] + "\n"
+		"variante " + NOMBRES_VARIANTE[registro.variante] + "\n"
+		"semilla " + std::to_string(registro.semilla) + "\n"
+		"samples " + std::to_string(registro.samples) + "\n"
+		"muestras_por_bloque " + std::to_string(registro.muestras_por_bloque) + "\n"
+		"suma " + formatear_exacto(registro.suma) + "\n";
+	return escribir_archivo_atomico(nombre_archivo, contenido);
+}
+
+/**
+ * Lee un registro guardado con guardar_registro
+ *
+ * @return true si el archivo existe, es válido y es compatible con esta versión
+ */
+bool cargar_registro(const char* nombre_archivo, RegistroEjecucion& registro) {
+	std::map<std::string, std::string> valores;
+	if (!leer_archivo_estado(nombre_archivo, "montecarlo_registro", 3,
+		{ "generador", "precision", "estimador", "variante", "semilla", "samples", "muestras_por_bloque", "suma" },
+		valores)) {
+		return false;
+	}
+
+	if (!leer_numero(valores["semilla"], registro.semilla) || !leer_numero(valores["samples"], registro.samples) ||
+		!leer_numero(valores["muestras_por_bloque"], registro.muestras_por_bloque) ||
+		!leer_numero(valores["suma"], registro.suma)) {
+		printf("Error: El registro %s tiene valores que no son numeros validos\n", nombre_archivo);
+		return false;
+	}
+
+	registro.generador = buscar_nombre(NOMBRES_GENERADOR, NUM_GENERADORES, valores["generador"]);
+	registro.precision = buscar_nombre(NOMBRES_PRECISION, NUM_PRECISIONES, valores["precision"]);
+	registro.estimador = buscar_nombre(NOMBRES_ESTIMADOR, NUM_ESTIMADORES, valores["estimador"]);
+	registro.variante = buscar_nombre(NOMBRES_VARIANTE, NUM_VARIANTES, valores["variante"]);
+
+	if (registro.generador < 0 || registro.precision < 0 || registro.estimador < 0 || registro.variante < 0 ||
+		registro.muestras_por_bloque != MUESTRAS_POR_BLOQUE) {
+		printf("Error: El registro %s es de otra configuracion\n", nombre_archivo);
+		return false;
+	}
+	if (registro.samples <= 0 || registro.suma < 0 || registro.suma > (double)registro.samples) {
+		printf("Error: El registro %s tiene un numero de muestras o una suma no validos\n", nombre_archivo);
+		return false;
+	}
+	return true;
+}
+
+// Percentil p (0..1) de un vector ya ordenado, por el método del rango más cercano
+static double percentil(const std::vector<double>& ordenados, double p) {
+	size_t rango = static_cast<size_t>(ceil(p * ordenados.size()));
+	if (rango == 0) rango = 1;
+	return ordenados[rango - 1];
+}
+
+/**
+ * INTERVALOS DE CONFIANZA A PARTIR DE LAS SUMAS POR LOTES
+ *
+ * Con --intervalos la versión paralela acumula la suma del estimador en
+ * LOTES_INTERVALO lotes de muestras consecutivas (ver SumasLotes: 32 sumas,
+ * sea cual sea el número de muestras) y al terminar calcula dos intervalos al
+ * 95 % sin generar más muestras:
+ *   - Medias por lotes: la dispersión de las estimaciones de los lotes da el
+ *     intervalo con la t de Student de LOTES_INTERVALO - 1 grados de libertad.
+ *     Sirve aunque las muestras de un lote no sean independientes entre sí,
+ *     mientras lo sean los lotes
+ *   - Bootstrap: REMUESTREOS_BOOTSTRAP remuestreos con reemplazo de los lotes,
+ *     e intervalo de percentiles
+ *
+ * Cada lote necesita al menos MUESTRAS_MIN_TROZO muestras; con menos no se
+ * calculan. Los remuestreos se hacen en un solo hilo, con un generador sembrado
+ * con la semilla de la ejecución, así que los intervalos tampoco dependen del
+ * número de hilos. Son 2000 · 32 elecciones de un lote y sumas, del orden de un
+ * milisegundo: un equipo de hilos costaría más de lo que ahorra.
+ */
+const int REMUESTREOS_BOOTSTRAP = 2000;
+const long long MUESTRAS_MIN_INTERVALOS = LOTES_INTERVALO * MUESTRAS_MIN_TROZO;
+
+// Cuantil 0,975 de la t de Student con 'grados' grados de libertad (1 a 31)
+static double cuantil_t_975(int grados) {
+	static const double tabla[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+		2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042, 2.040 };
+	const int filas = sizeof(tabla) / sizeof(tabla[0]);
+	return grados <= filas ? tabla[grados - 1] : 1.960;
+}
+
+/**
+ * Rellena los intervalos de confianza del resultado
+ *
+ * @param lotes: Sumas por lotes de todas las muestras de la ejecución
+ * @param nucleo: Núcleo usado (para convertir sumas en estimaciones de π)
+ */
+static void calcular_intervalos(ResultadoMontecarlo& r, const SumasLotes& lotes, const EntradaNucleo* nucleo) {
+	for (int k = 0; k < LOTES_INTERVALO; k++) {
+		if (lotes.muestras[k] <= 0) {
+			return;  // Lote vacío (ejecución demasiado corta): sin intervalos
+		}
+	}
+
+	// Medias por lotes
+	double estimaciones[LOTES_INTERVALO];
+	double media = 0.0;
+	for (int k = 0; k < LOTES_INTERVALO; k++) {
+		estimaciones[k] = nucleo->a_pi(lotes.suma[k], lotes.muestras[k]);
+		media += estimaciones[k] / LOTES_INTERVALO;
+	}
+	double cuadrados = 0.0;
+	for (double e : estimaciones) {
+		cuadrados += (e - media) * (e - media);
+	}
+	double semiancho = cuantil_t_975(LOTES_INTERVALO - 1) *
+		sqrt(cuadrados / (LOTES_INTERVALO - 1) / LOTES_INTERVALO);
+	r.ic_lotes_inferior = r.pi - semiancho;
+	r.ic_lotes_superior = r.pi + semiancho;
+
+	// Bootstrap de los lotes: REMUESTREOS_BOOTSTRAP · LOTES_INTERVALO elecciones,
+	// en serie (ver el comentario de la sección)
+	std::vector<double> remuestreos(REMUESTREOS_BOOTSTRAP);
+	std::mt19937_64 gen;
+	sembrar_bloque(gen, r.semilla ^ 0x9E3779B97F4A7C15ULL, 0);  // Distinta de la del muestreo
+	std::uniform_int_distribution<int> elegir(0, LOTES_INTERVALO - 1);
+	for (int k = 0; k < REMUESTREOS_BOOTSTRAP; k++) {
+		double suma = 0.0;
+		long long n = 0;
+		for (int j = 0; j < LOTES_INTERVALO; j++) {
+			int lote = elegir(gen);
+			suma += lotes.suma[lote];
+			n += lotes.muestras[lote];
+		}
+		remuestreos[k] = nucleo->a_pi(suma, n);
+	}
+	std::sort(remuestreos.begin(), remuestreos.end());
+	r.ic_bootstrap_inferior = percentil(remuestreos, 0.025);
+	r.ic_bootstrap_superior = percentil(remuestreos, 0.975);
+}
+
 /**
  * IMPLEMENTACIÓN PARALELA DEL MÉTODO DE MONTE CARLO USANDO OPENMP
  *
+ * Las muestras se procesan por bloques (ver sumar_bloque). Si se indica
+ * un archivo de checkpoint, los bloques se recorren en tandas y al final de cada
+ * tanda se guarda el progreso cuando ha pasado el intervalo configurado.
+ *
+ * Si se cancela (ver ControlEjecucion), el resultado usa las muestras completadas
+ * hasta ese momento y el checkpoint conserva el último prefijo completo de bloques,
+ * desde el que se puede reanudar.
+ *
  * @param samples: Número de puntos aleatorios a generar
+ * @param opciones: Hilos, semilla y checkpoints (ver OpcionesParalelo)
  * @return ResultadoMontecarlo: Estructura con el valor de π y estadísticas de tiempo
  */
-ResultadoMontecarlo montecarlo_paralelo(long long samples) {
-	unsigned long long count = 0;  // Contador global (compartido entre hilos)
-	long long i, a;
-	double x, y;                   // Variables para coordenadas (privadas por hilo)
+ResultadoMontecarlo montecarlo_paralelo(long long samples, const OpcionesParalelo& opciones) {
+	double count = 0;              // Suma global del estimador (aciertos en acierto-fallo)
+	long long a;
 	double inicio, final, total = 0;
 	ResultadoMontecarlo resultado;
 
 	// Inicializar datos del resultado
 	resultado.samples = samples;
 	resultado.es_paralelo = true;
+	resultado.metodo = "OpenMP";
 
 	// Configuración de paralelismo
 	a = omp_get_num_procs();       // Obtener número de procesadores físicos
-	int num_threads = 8;           // Establecer número de hilos
-	omp_set_num_threads(num_threads);
-	resultado.num_hilos = num_threads;
+	int num_threads = opciones.num_hilos;
 
 	// Iniciar cronómetro
 	inicio = omp_get_wtime();
 
-	// Inicialización del generador de semillas de alta calidad
-	std::random_device rd;         // Obtiene entropía del hardware si está disponible
-	unsigned int seed_base = rd(); // Semilla base compartida entre todos los hilos
+	// Semilla base (fija o aleatoria)
+	unsigned long long seed_base = obtener_semilla(opciones);
 
-	// Inicio de la región paralela
-#pragma omp parallel private(x,y)
-	{
-		// Código ejecutado por cada hilo:
-
-		// 1. Obtener ID único del hilo actual
-		int tid = omp_get_thread_num();
-
-		// 2. Crear semilla única para este hilo
-		// Usamos XOR con una constante derivada de la proporción áurea (0x9e3779b9)
-		// para dispersar bien los valores y evitar correlaciones
-		unsigned int seed = seed_base ^ (static_cast<unsigned int>(tid) + 1) * 0x9e3779b9;
-
-		// 3. Inicializar generador Mersenne Twister con esta semilla
-		// Este generador tiene excelentes propiedades estadísticas:
-		// - Período extremadamente largo (2^19937-1)
-		// - Distribución uniforme en 623 dimensiones
-		// - Pasa todos los tests estadísticos conocidos
-		std::mt19937 gen(seed);
-
-		// 4. Configurar distribución uniforme real en [0,1)
-		std::uniform_real_distribution<double> dis(0.0, 1.0);
-
-		// 5. Repartir iteraciones entre los hilos disponibles
-		// La cláusula reduction(+:count) combina automáticamente los contadores parciales
-#pragma omp for reduction(+:count)
-		for (i = 0; i < samples; ++i) {
-			// Generar par de coordenadas aleatorias usando nuestro generador de alta calidad
-			x = dis(gen);
-			y = dis(gen);
-
-			// Comprobar si el punto está dentro del círculo unitario
-			if (x * x + y * y <= 1.0) {
-				++count;  // Incrementar contador si está dentro
-			}
+	long long num_bloques = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	long long bloque_actual = 0;
+	OpcionesParalelo efectivas = opciones;
+
+	// Continuar desde un checkpoint: se recuperan la semilla, el generador, los
+	// bloques ya hechos y sus aciertos, y se sigue exactamente donde se quedó
+	if (opciones.reanudar_desde != nullptr) {
+		const EstadoCheckpoint& previo = *opciones.reanudar_desde;
+		seed_base = previo.semilla;
+		efectivas.generador = previo.generador;
+		efectivas.precision = previo.precision;
+		efectivas.estimador = previo.estimador;
+		efectivas.variante = previo.variante;
+		bloque_actual = previo.bloques_completados;
+		count = previo.suma;
+		printf("Reanudando desde el bloque %lld de %lld\n", bloque_actual, num_bloques);
+	}
+
+	// Hilos que reciben trabajo: menos que los pedidos si hay pocas muestras
+	resultado.num_hilos = hilos_efectivos(bloque_actual * MUESTRAS_POR_BLOQUE, samples, num_threads);
+
+	// Sumas por lotes para los intervalos de confianza (no hay las de los
+	// bloques anteriores a un checkpoint)
+	SumasLotes lotes;
+	if (opciones.intervalos && opciones.reanudar_desde == nullptr && samples >= MUESTRAS_MIN_INTERVALOS) {
+		lotes.hasta = samples;
+		efectivas.lotes = &lotes;
+	}
+
+	ControlEjecucion* control = opciones.control;
+	if (control != nullptr) {
+		control->bloques_totales = num_bloques;
+		control->bloques_hechos.store(bloque_actual);
+		control->siguiente_aviso = bloque_actual + control->bloques_entre_avisos;
+	}
+	long long hechas = bloque_actual * MUESTRAS_POR_BLOQUE;
+	if (hechas > samples) hechas = samples;
+	double count_parcial = 0;              // Suma de una tanda interrumpida
+	long long hechas_parcial = 0;
+	bool cancelado = false;
+
+	// Sin checkpoints todos los bloques forman una única tanda. Con checkpoints,
+	// cada tanda da unos cientos de bloques a cada hilo, suficiente para que la
+	// barrera del final de tanda no se note
+	long long bloques_por_tanda = num_bloques;
+	if (opciones.archivo_checkpoint != nullptr) {
+		bloques_por_tanda = 256LL * num_threads;
+	}
+	double ultimo_checkpoint = inicio;
+
+	while (bloque_actual < num_bloques) {
+		long long fin_tanda = bloque_actual + bloques_por_tanda;
+		if (fin_tanda > num_bloques) fin_tanda = num_bloques;
+
+		long long desde = bloque_actual * MUESTRAS_POR_BLOQUE;
+		long long hasta = fin_tanda * MUESTRAS_POR_BLOQUE;
+		if (hasta > samples) hasta = samples;
+
+		long long hechas_tanda;
+		double count_tanda = contar_rango_paralelo(seed_base, desde, hasta, efectivas,
+			hechas_tanda);
+		if (hechas_tanda < hasta - desde) {
+			// Tanda interrumpida: sus bloques completados cuentan para el resultado,
+			// pero no forman un prefijo contiguo y no entran en el checkpoint
+			count_parcial = count_tanda;
+			hechas_parcial = hechas_tanda;
+			cancelado = true;
+		}
+		else {
+			count += count_tanda;
+			hechas += hechas_tanda;
+			bloque_actual = fin_tanda;
+		}
+
+		// Guardar progreso si ha pasado el intervalo (y siempre al terminar o cancelar)
+		double ahora = omp_get_wtime();
+		if (opciones.archivo_checkpoint != nullptr &&
+			(ahora - ultimo_checkpoint >= opciones.intervalo_checkpoint_s ||
+				bloque_actual == num_bloques || cancelado)) {
+			EstadoCheckpoint estado;
+			estado.semilla = seed_base;
+			estado.samples = samples;
+			estado.muestras_por_bloque = MUESTRAS_POR_BLOQUE;
+			estado.bloques_completados = bloque_actual;
+			estado.suma = count;
+			estado.generador = efectivas.generador;
+			estado.precision = efectivas.precision;
+			estado.estimador = efectivas.estimador;
+			estado.variante = efectivas.variante;
+			guardar_checkpoint(opciones.archivo_checkpoint, estado);
+			ultimo_checkpoint = ahora;
+		}
+		if (cancelado) {
+			break;
 		}
-		// Al final del bloque paralelo, OpenMP combina automáticamente todos los
-		// contadores parciales en la variable count (gracias a reduction)
 	}
 
 	// Detener cronómetro y calcular tiempo
 	final = omp_get_wtime();
 	total = (final - inicio);
 
-	// Calcular π y almacenar resultados
-	resultado.pi = 4.0 * count / samples;
+	// Calcular π y almacenar resultados (con las muestras hechas si se canceló)
+	count += count_parcial;
+	hechas += hechas_parcial;
+	resultado.samples = hechas;
+	resultado.pi = hechas > 0 ? seleccionar_nucleo(efectivas)->a_pi(count, hechas) : 0.0;
+	resultado.suma = count;
+	resultado.semilla = seed_base;
+	resultado.cancelado = cancelado;
+	resultado.bits_coordenada = seleccionar_nucleo(efectivas)->bits_coordenada;
 	resultado.tiempo_segundos = total;
 	resultado.tiempo_ms = total * 1e3;
 	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, hechas > 0 ? seleccionar_nucleo(efectivas)->error_estandar(resultado.pi, hechas) : 0.0);
+
+	// Intervalos de confianza (fuera del tiempo medido)
+	double tiempo_intervalos = 0.0;
+	if (efectivas.lotes != nullptr && !cancelado) {
+		double inicio_intervalos = omp_get_wtime();
+		calcular_intervalos(resultado, lotes, seleccionar_nucleo(efectivas));
+		tiempo_intervalos = omp_get_wtime() - inicio_intervalos;
+	}
 
 	// Mostrar resultados por consola
 	printf("----------------OpenMP MonterCarlo Paralelizado----------------\n");
 	printf("Numero de Procesadores: %lld\n", a);
-	printf("Numero de Hilos utilizados: %d\n", num_threads);
+	printf("Numero de Hilos utilizados: %d", resultado.num_hilos);
+	if (resultado.num_hilos < num_threads) {
+		printf(" (de %d pedidos: no hay trabajo para mas)", num_threads);
+	}
+	printf("\n");
+	printf("Nucleo: %s/%s/%s, %s, reparto %s,%d\n", NOMBRES_ESTIMADOR[efectivas.estimador],
+		NOMBRES_GENERADOR[efectivas.generador], NOMBRES_PRECISION[efectivas.precision],
+		describir_variante(efectivas).c_str(),
+		NOMBRES_PLANIFICACION[efectivas.planificacion], efectivas.bloques_por_chunk);
+	if (efectivas.generador == GEN_AES_CTR) {
+		printf("AES-NI: %s\n", aes_ni_disponible() ? "si" : "no (AES por software)");
+	}
+	if (efectivas.estimador == EST_ACIERTOS_TABLA) {
+		printf("Rejilla del cuadrante: %dx%d celdas (%d bytes)\n", TablaCuadrante::N, TablaCuadrante::N,
+			(int)sizeof(TABLA_CUADRANTE.celdas));
+	}
 	printf("Numero de Samples = %lld\n", samples);
+	if (cancelado) {
+		printf("Ejecucion CANCELADA tras %lld samples\n", hechas);
+	}
+	printf("Semilla = %llu\n", seed_base);
+	printf("Resolucion = %d bits por coordenada\n", resultado.bits_coordenada);
 	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
+	if (resultado.ic_lotes_inferior == resultado.ic_lotes_inferior) {
+		printf("IC 95%% medias por lotes = [%.12f, %.12f]\n", resultado.ic_lotes_inferior, resultado.ic_lotes_superior);
+		printf("IC 95%% bootstrap        = [%.12f, %.12f] (%.3f ms)\n", resultado.ic_bootstrap_inferior,
+			resultado.ic_bootstrap_superior, tiempo_intervalos * 1e3);
+	}
+	else if (opciones.intervalos && opciones.reanudar_desde != nullptr) {
+		printf("Sin intervalos: faltan las sumas de las muestras anteriores al checkpoint\n");
+	}
+	else if (opciones.intervalos && samples < MUESTRAS_MIN_INTERVALOS) {
+		printf("Sin intervalos: hacen falta al menos %lld samples (%d lotes de %lld)\n",
+			MUESTRAS_MIN_INTERVALOS, LOTES_INTERVALO, MUESTRAS_MIN_TROZO);
+	}
 	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
 	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
 	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
@@ -201,20 +1111,1309 @@ ResultadoMontecarlo montecarlo_paralelo(long long samples) {
 	return resultado;
 }
 
+// Archivo donde el autotuner guarda la mejor configuración de cada máquina
+const char* const ARCHIVO_AUTOTUNE = "autotune_montecarlo.txt";
+bool cargar_autotune(const char* nombre_archivo, OpcionesParalelo& o);
+
 /**
- * Función para guardar los resultados en un archivo CSV con formato español
- *
- * @param secuencial: Resultados del método secuencial
- * @param paralelo: Resultados del método paralelo
- * @param nombre_archivo: Ruta del archivo CSV a crear/modificar
- * @param primera_escritura: Si es true, crea nuevo archivo; si es false, añade al existente
+ * Versión paralela con las opciones por defecto: semilla aleatoria y la
+ * configuración del autotuner para esta máquina si existe (si no, 8 hilos)
  */
-void guardar_csv(const ResultadoMontecarlo& secuencial, const ResultadoMontecarlo& paralelo,
-	const char* nombre_archivo, bool primera_escritura = true) {
-	// Abrir el archivo en modo apropiado
-	std::ofstream archivo;
+ResultadoMontecarlo montecarlo_paralelo(long long samples) {
+	OpcionesParalelo opciones;
+	cargar_autotune(ARCHIVO_AUTOTUNE, opciones);
+	return montecarlo_paralelo(samples, opciones);
+}
 
-	if (primera_escritura) {
+/**
+ * AMPLIACIÓN INCREMENTAL DE UNA ESTIMACIÓN PREVIA
+ *
+ * Partiendo del registro de una ejecución de N muestras, calcula solo las
+ * muestras [N, M) con la misma semilla y suma su resultado al previo.
+ * Como cada muestra depende únicamente de (semilla, índice), el resultado es
+ * idéntico al de una ejecución nueva de M muestras con esa semilla.
+ *
+ * @param previo: Registro de la ejecución a ampliar
+ * @param samples: Número total de muestras deseado (M > N)
+ * @param opciones: Hilos y reparto; la semilla y el núcleo (generador, precisión,
+ *                  estimador y variante) son los del registro
+ * @return ResultadoMontecarlo: Estimación con M muestras (el tiempo es solo el de [N, M))
+ */
+ResultadoMontecarlo extender_estimacion(const RegistroEjecucion& previo, long long samples,
+	const OpcionesParalelo& opciones) {
+	double inicio, final, total = 0;
+	ResultadoMontecarlo resultado;
+
+	resultado.samples = samples;
+	resultado.es_paralelo = true;
+	resultado.metodo = "OpenMP";
+	resultado.num_hilos = hilos_efectivos(previo.samples, samples, opciones.num_hilos);
+	resultado.semilla = previo.semilla;
+	resultado.cancelado = false;
+
+	// Solo se generan las muestras nuevas
+	inicio = omp_get_wtime();
+	OpcionesParalelo efectivas = opciones;
+	efectivas.generador = previo.generador;
+	efectivas.precision = previo.precision;
+	efectivas.estimador = previo.estimador;
+	efectivas.variante = previo.variante;
+	double nuevos = contar_rango_paralelo(previo.semilla, previo.samples, samples, efectivas);
+	final = omp_get_wtime();
+	total = (final - inicio);
+
+	const EntradaNucleo* nucleo = seleccionar_nucleo(efectivas);
+	resultado.suma = previo.suma + nuevos;
+	resultado.pi = nucleo->a_pi(resultado.suma, samples);
+	resultado.bits_coordenada = nucleo->bits_coordenada;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, nucleo->error_estandar(resultado.pi, samples));
+
+	// Mostrar resultados por consola
+	printf("----------------OpenMP MonterCarlo Ampliado----------------\n");
+	printf("Numero de Hilos utilizados: %d\n", resultado.num_hilos);
+	printf("Samples previos = %lld, Samples totales = %lld\n", previo.samples, samples);
+	printf("Semilla = %llu\n", previo.semilla);
+	printf("Resolucion = %d bits por coordenada\n", resultado.bits_coordenada);
+	printf("pi previo = %.12f\n", nucleo->a_pi(previo.suma, previo.samples));
+	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec. de las muestras nuevas (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec. de las muestras nuevas (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec. de las muestras nuevas (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * MODO CON PRESUPUESTO DE TIEMPO
+ *
+ * En lugar de fijar el número de muestras, cada hilo toma unidades de un
+ * contador atómico compartido y genera tantas muestras como quepan antes del
+ * límite. Cada unidad son las MUESTRAS_POR_COMPROBACION primeras muestras del
+ * bloque de su índice, sumadas con el núcleo elegido (tabla de núcleos, como la
+ * versión paralela), y tras cada una se comprueba el límite: primero una
+ * bandera compartida (lectura barata) y después el reloj; el primer hilo que ve
+ * el límite vencido levanta la bandera para que los demás paren sin consultar
+ * el reloj. Las unidades no continúan la secuencia de un bloque porque los
+ * núcleos tendrían que avanzar el generador hasta la mitad del bloque en cada
+ * llamada. El resultado no es reproducible (depende de cuánto avanzó cada hilo),
+ * pero sí insesgado, porque el momento de parar no depende de los valores generados.
+ *
+ * @param presupuesto_s: Tiempo disponible en segundos
+ * @param opciones: Hilos, núcleo, semilla y control de cancelación (no se usan checkpoints)
+ * @return ResultadoMontecarlo: samples contiene las muestras realmente generadas,
+ *         num_hilos los hilos que formaron el equipo y tiempo_segundos el tiempo
+ *         total, cuyo exceso sobre el presupuesto es el retraso
+ */
+ResultadoMontecarlo montecarlo_presupuesto(double presupuesto_s, const OpcionesParalelo& opciones) {
+	double count = 0;
+	long long hechas = 0;
+	int hilos_equipo = 1;
+	ResultadoMontecarlo resultado;
+
+	double inicio = omp_get_wtime();
+	double limite = inicio + presupuesto_s;
+
+	unsigned long long seed_base = obtener_semilla(opciones);
+	const EntradaNucleo* nucleo = seleccionar_nucleo(opciones);
+	FuncionBloque contar_bloque = nucleo->sumar;
+
+	std::atomic<long long> siguiente_unidad(0);
+	std::atomic<bool> agotado(false);
+	std::atomic<bool>* cancelado = opciones.control != nullptr ? &opciones.control->cancelado : nullptr;
+
+#pragma omp parallel reduction(+:count,hechas) num_threads(opciones.num_hilos)
+	{
+#pragma omp single nowait
+		hilos_equipo = omp_get_num_threads();
+
+		while (!agotado.load(std::memory_order_relaxed)) {
+			long long u = siguiente_unidad.fetch_add(1, std::memory_order_relaxed);
+			long long desde = u * MUESTRAS_POR_BLOQUE;
+			count += contar_bloque(seed_base, u, desde, desde + MUESTRAS_POR_COMPROBACION);
+			hechas += MUESTRAS_POR_COMPROBACION;
+			if (omp_get_wtime() >= limite ||
+				(cancelado != nullptr && cancelado->load(std::memory_order_relaxed))) {
+				agotado.store(true, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	double total = omp_get_wtime() - inicio;
+
+	resultado.samples = hechas;
+	resultado.es_paralelo = true;
+	resultado.metodo = "OpenMP";
+	resultado.num_hilos = hilos_equipo;
+	resultado.suma = count;
+	resultado.semilla = seed_base;
+	resultado.cancelado = agotado.load() && opciones.control != nullptr &&
+		opciones.control->cancelado.load();
+	resultado.bits_coordenada = nucleo->bits_coordenada;
+	resultado.pi = hechas > 0 ? nucleo->a_pi(count, hechas) : 0.0;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, hechas > 0 ? nucleo->error_estandar(resultado.pi, hechas) : 0.0);
+	return resultado;
+}
+
+/**
+ * SELECCIÓN AUTOMÁTICA SECUENCIAL / PARALELO
+ *
+ * Para pocas muestras abrir un equipo de hilos cuesta más que el propio cálculo
+ * (en el CSV original, 1000 muestras tardan 0,14 ms en secuencial y 5,56 ms con
+ * OpenMP). La calibración mide en esta máquina a partir de qué tamaño compensa
+ * un equipo pequeño de hilos y a partir de cuál el equipo completo. Como las tres
+ * rutas recorren los mismos bloques, el valor de π no depende de la ruta elegida.
+ */
+struct CalibracionAuto {
+	int procesadores;              // omp_get_num_procs() al calibrar
+	int hilos_equipo_pequeno;
+	int hilos_equipo_completo;
+	long long umbral_equipo_pequeno;  // Desde aquí el equipo pequeño gana al secuencial
+	long long umbral_equipo_completo; // Desde aquí el equipo completo gana al pequeño
+};
+
+const long long SIN_UMBRAL = 0x7fffffffffffffffLL;  // La ruta nunca compensa
+
+// Mediana de varias mediciones de contar_rango con 'hilos' hilos (0 = secuencial).
+// Se usa la mediana y no el mínimo para no ocultar el coste de despertar a los hilos.
+static double medir_ruta(long long samples, int hilos, const OpcionesParalelo& opciones) {
+	const int repeticiones = 5;
+	std::vector<double> tiempos;
+	OpcionesParalelo ruta = opciones;
+	ruta.num_hilos = hilos;
+	for (int r = 0; r < repeticiones; r++) {
+		double inicio = omp_get_wtime();
+		if (hilos == 0) {
+			contar_rango_secuencial(r, 0, samples, ruta);
+		}
+		else {
+			contar_rango_paralelo(r, 0, samples, ruta);
+		}
+		tiempos.push_back(omp_get_wtime() - inicio);
+	}
+	std::sort(tiempos.begin(), tiempos.end());
+	return tiempos[repeticiones / 2];
+}
+
+/**
+ * Calibra los puntos de cruce midiendo las tres rutas con 1000, 2000, 4000, ...
+ * 4096000 muestras. Los tamaños pequeños quedan por debajo de un bloque: el
+ * motor paralelo parte los bloques en trozos (ver trozos_por_bloque), así que
+ * también ahí se mide el reparto real entre los hilos y el cruce, que suele
+ * estar entre 1000 y 5000 muestras, cae dentro de la rejilla medida.
+ * Un umbral es el menor tamaño a partir del cual la ruta correspondiente gana en
+ * todos los tamaños medidos mayores.
+ */
+CalibracionAuto calibrar_cruce(const OpcionesParalelo& opciones) {
+	int hilos_completo = opciones.num_hilos;
+	CalibracionAuto calibracion;
+	calibracion.procesadores = omp_get_num_procs();
+	calibracion.hilos_equipo_completo = hilos_completo;
+	calibracion.hilos_equipo_pequeno = hilos_completo / 4 > 2 ? hilos_completo / 4 : 2;
+	if (calibracion.hilos_equipo_pequeno > hilos_completo) {
+		calibracion.hilos_equipo_pequeno = hilos_completo;
+	}
+	calibracion.umbral_equipo_pequeno = SIN_UMBRAL;
+	calibracion.umbral_equipo_completo = SIN_UMBRAL;
+
+	printf("Calibrando punto de cruce secuencial/paralelo...\n");
+	std::vector<long long> tamanos;
+	std::vector<double> t_sec, t_peq, t_comp;
+	for (long long n = 1000; n <= 4096000; n *= 2) {
+		tamanos.push_back(n);
+		t_sec.push_back(medir_ruta(n, 0, opciones));
+		t_peq.push_back(medir_ruta(n, calibracion.hilos_equipo_pequeno, opciones));
+		t_comp.push_back(medir_ruta(n, calibracion.hilos_equipo_completo, opciones));
+		printf("  %10lld samples: secuencial %.3f ms, %d hilos %.3f ms, %d hilos %.3f ms\n", n,
+			t_sec.back() * 1e3, calibracion.hilos_equipo_pequeno, t_peq.back() * 1e3,
+			calibracion.hilos_equipo_completo, t_comp.back() * 1e3);
+	}
+
+	// Recorrer de mayor a menor tamaño mientras siga ganando alguna ruta paralela
+	// (primer umbral) o el equipo completo a las otras dos (segundo umbral)
+	for (int k = (int)tamanos.size() - 1; k >= 0 && (t_peq[k] < t_sec[k] || t_comp[k] < t_sec[k]); k--) {
+		calibracion.umbral_equipo_pequeno = tamanos[k];
+	}
+	for (int k = (int)tamanos.size() - 1; k >= 0 && t_comp[k] < t_sec[k] && t_comp[k] < t_peq[k]; k--) {
+		calibracion.umbral_equipo_completo = tamanos[k];
+	}
+	return calibracion;
+}
+
+bool guardar_calibracion(const char* nombre_archivo, const CalibracionAuto& c) {
+	std::string contenido = "montecarlo_calibracion 1\n"
+		"procesadores " + std::to_string(c.procesadores) + "\n"
+		"hilos_equipo_pequeno " + std::to_string(c.hilos_equipo_pequeno) + "\n"
+		"hilos_equipo_completo " + std::to_string(c.hilos_equipo_completo) + "\n"
+		"umbral_equipo_pequeno " + std::to_string(c.umbral_equipo_pequeno) + "\n"
+		"umbral_equipo_completo " + std::to_string(c.umbral_equipo_completo) + "\n";
+	return escribir_archivo_atomico(nombre_archivo, contenido);
+}
+
+/**
+ * Lee una calibración guardada. Solo se acepta si se hizo en una máquina con el
+ * mismo número de procesadores y para el mismo tamaño de equipo.
+ */
+bool cargar_calibracion(const char* nombre_archivo, int hilos_completo, CalibracionAuto& c) {
+	std::map<std::string, std::string> valores;
+	if (!std::filesystem::exists(nombre_archivo) ||
+		!leer_archivo_estado(nombre_archivo, "montecarlo_calibracion", 1,
+			{ "procesadores", "hilos_equipo_pequeno", "hilos_equipo_completo",
+			  "umbral_equipo_pequeno", "umbral_equipo_completo" }, valores)) {
+		return false;
+	}
+	if (!leer_numero(valores["procesadores"], c.procesadores) ||
+		!leer_numero(valores["hilos_equipo_pequeno"], c.hilos_equipo_pequeno) ||
+		!leer_numero(valores["hilos_equipo_completo"], c.hilos_equipo_completo) ||
+		!leer_numero(valores["umbral_equipo_pequeno"], c.umbral_equipo_pequeno) ||
+		!leer_numero(valores["umbral_equipo_completo"], c.umbral_equipo_completo) ||
+		c.hilos_equipo_pequeno < 1 || c.hilos_equipo_pequeno > c.hilos_equipo_completo ||
+		c.umbral_equipo_pequeno < 1 || c.umbral_equipo_completo < 1) {
+		printf("Aviso: Se ignora la calibracion de %s (valores no validos)\n", nombre_archivo);
+		return false;
+	}
+	return c.procesadores == omp_get_num_procs() && c.hilos_equipo_completo == hilos_completo;
+}
+
+/**
+ * MODO AUTOMÁTICO: envía cada petición a la ruta más rápida según la calibración
+ *
+ * @param samples: Número de puntos aleatorios a generar
+ * @param calibracion: Puntos de cruce medidos en esta máquina
+ * @param opciones: Semilla y control (el número de hilos lo decide la calibración)
+ */
+ResultadoMontecarlo montecarlo_auto(long long samples, const CalibracionAuto& calibracion,
+	const OpcionesParalelo& opciones) {
+	ResultadoMontecarlo resultado;
+
+	if (samples >= calibracion.umbral_equipo_pequeno) {
+		OpcionesParalelo opciones_ruta = opciones;
+		opciones_ruta.num_hilos = samples >= calibracion.umbral_equipo_completo ?
+			calibracion.hilos_equipo_completo : calibracion.hilos_equipo_pequeno;
+		printf("Modo auto: ruta paralela con %d hilos\n", opciones_ruta.num_hilos);
+		resultado = montecarlo_paralelo(samples, opciones_ruta);
+		resultado.metodo = "Auto";
+		return resultado;
+	}
+
+	// Ruta secuencial: mismos bloques, sin región paralela
+	printf("Modo auto: ruta secuencial\n");
+	double inicio = omp_get_wtime();
+	unsigned long long seed_base = obtener_semilla(opciones);
+	double count = contar_rango_secuencial(seed_base, 0, samples, opciones);
+	double total = omp_get_wtime() - inicio;
+
+	resultado.samples = samples;
+	resultado.es_paralelo = false;
+	resultado.metodo = "Auto";
+	resultado.num_hilos = 1;
+	resultado.suma = count;
+	resultado.semilla = seed_base;
+	resultado.cancelado = false;
+	resultado.pi = seleccionar_nucleo(opciones)->a_pi(count, samples);
+	resultado.bits_coordenada = seleccionar_nucleo(opciones)->bits_coordenada;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, seleccionar_nucleo(opciones)->error_estandar(resultado.pi, samples));
+
+	printf("----------------MonteCarlo Auto (secuencial)----------------\n");
+	printf("Numero de Samples = %lld\n", samples);
+	printf("Semilla = %llu\n", seed_base);
+	printf("Resolucion = %d bits por coordenada\n", resultado.bits_coordenada);
+	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * RECUENTO DETERMINISTA DE PUNTOS DE RETÍCULA
+ *
+ * Punto de comparación para los núcleos estocásticos: en lugar de puntos
+ * aleatorios se cuentan los centros de las R x R celdas de lado 1/R que caen
+ * dentro del cuarto de círculo. Por filas no hace falta recorrer las celdas:
+ * en la fila i los centros ((i + 1/2) / R, (j + 1/2) / R) están dentro mientras
+ * (2j + 1)² <= 4R² - (2i + 1)², así que cada fila cuesta una raíz entera y el
+ * total es O(R) para R² "muestras". El error baja como R^(-3/2) aproximadamente,
+ * frente a N^(-1/2) de Monte Carlo con N = R² puntos.
+ */
+
+// Raíz cuadrada entera: el mayor s con s² <= n
+static unsigned long long raiz_entera(unsigned long long n) {
+	unsigned long long s = (unsigned long long)sqrt((double)n);
+	while (s > 0 && s * s > n) --s;                 // Corregir el redondeo de la raíz en double
+	while ((s + 1) * (s + 1) <= n) ++s;
+	return s;
+}
+
+/**
+ * Estima π contando los centros de celda dentro del cuarto de círculo
+ *
+ * @param radio: Celdas por lado (R). Limitado a 10^9 para que 4R² quepa en 64 bits
+ * @param num_hilos: Hilos que se reparten las filas
+ * @return ResultadoMontecarlo con samples = R² (celdas evaluadas)
+ */
+ResultadoMontecarlo montecarlo_reticula(long long radio, int num_hilos) {
+	ResultadoMontecarlo resultado;
+	unsigned long long cuenta = 0;
+	const unsigned long long cuatro_r2 = 4ULL * (unsigned long long)radio * (unsigned long long)radio;
+	long long i;
+
+	double inicio = omp_get_wtime();
+#pragma omp parallel for schedule(static) reduction(+:cuenta) num_threads(num_hilos)
+	for (i = 0; i < radio; ++i) {
+		unsigned long long impar = 2ULL * i + 1;
+		// Centros de la fila: valores impares m = 2j + 1 con m² <= 4R² - (2i + 1)²
+		cuenta += (raiz_entera(cuatro_r2 - impar * impar) + 1) / 2;
+	}
+	double total = omp_get_wtime() - inicio;
+
+	resultado.samples = radio * radio;
+	resultado.es_paralelo = num_hilos > 1;
+	resultado.metodo = "Reticula";
+	resultado.num_hilos = num_hilos;
+	resultado.suma = (double)cuenta;
+	resultado.semilla = 0;
+	resultado.cancelado = false;
+	resultado.bits_coordenada = 0;
+	resultado.pi = 4.0 * (double)cuenta / ((double)radio * (double)radio);
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, 0.0);  // Determinista: sin error estándar
+
+	printf("----------------Reticula determinista----------------\n");
+	printf("Radio = %lld (%lld celdas)\n", radio, resultado.samples);
+	printf("Numero de Hilos utilizados: %d\n", num_hilos);
+	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+// Radio de la retícula con tantas celdas como 'samples' (redondeando hacia arriba)
+static long long radio_equivalente(long long samples) {
+	long long radio = (long long)raiz_entera((unsigned long long)samples);
+	return radio * radio < samples ? radio + 1 : radio;
+}
+
+// Primeras 50 cifras de π, para comprobar el cálculo de Chudnovsky
+const char* const CIFRAS_PI_CONOCIDAS = "3.14159265358979323846264338327950288419716939937510";
+
+/**
+ * Calcula π con Chudnovsky como carga de trabajo de CPU para las pruebas de
+ * escalado (la división binaria reparte el trabajo entre los hilos)
+ *
+ * @param cifras: Cifras decimales pedidas (hace las veces de samples en el CSV)
+ * @param num_hilos: Hilos de la división binaria y de las multiplicaciones finales
+ * @return ResultadoMontecarlo con el método "Chudnovsky"
+ */
+ResultadoMontecarlo calcular_referencia(long long cifras, int num_hilos) {
+	ResultadoMontecarlo resultado;
+	double inicio = omp_get_wtime();
+	ValorPi valor = calcular_pi_chudnovsky(cifras, num_hilos);
+	double total = omp_get_wtime() - inicio;
+
+	resultado.samples = cifras;
+	resultado.es_paralelo = num_hilos > 1;
+	resultado.metodo = "Chudnovsky";
+	resultado.num_hilos = num_hilos;
+	resultado.suma = 0;
+	resultado.semilla = 0;
+	resultado.cancelado = false;
+	resultado.bits_coordenada = 0;
+	resultado.pi = valor.alto;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, 0.0);
+
+	int mostradas = cifras < 50 ? (int)cifras : 50;
+	std::string inicio_cifras = cifras_pi(valor, mostradas);
+	bool correctas = inicio_cifras == std::string(CIFRAS_PI_CONOCIDAS).substr(0, mostradas + 2);
+
+	printf("----------------Referencia de pi (Chudnovsky)----------------\n");
+	printf("Cifras = %lld (%lld bits)\n", cifras, valor.bits_fraccion);
+	printf("Numero de Hilos utilizados: %d\n", num_hilos);
+	printf("pi = %s... (%s)\n", inicio_cifras.c_str(), correctas ? "correcto" : "INCORRECTO");
+	printf("Division binaria => %.6lf s, raiz y division final => %.6lf s\n",
+		valor.tiempo_serie_s, valor.tiempo_final_s);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * π COMO UNA INSTANCIA DEL INTEGRADOR GENÉRICO
+ *
+ * La integral de 4·[x² + y² <= 1] sobre [0, 1]² vale π. El integrando se escribe
+ * por lotes (un bucle sin llamadas sobre cada lote de puntos) y el generador se
+ * elige con la misma opción --generador que la versión paralela.
+ */
+
+// Integrando por lotes: 4 dentro del cuarto de círculo, 0 fuera
+struct IntegrandoCuartoCirculo {
+	void operator()(const double* puntos, int n, double* valores) const {
+		for (int k = 0; k < n; ++k) {
+			double x = puntos[2 * k], y = puntos[2 * k + 1];
+			valores[k] = x * x + y * y <= 1.0 ? 4.0 : 0.0;
+		}
+	}
+};
+
+// Instancia integrar con el generador pedido en tiempo de ejecución
+template <class F, int D>
+static ResultadoIntegral integrar_con_generador(int generador, F f, const Dominio<D>& dominio,
+	long long samples, const PoliticaIntegracion& politica) {
+	switch (generador) {
+	case GEN_MT19937_64: return integrar<std::mt19937_64>(f, dominio, samples, politica);
+	case GEN_XOSHIRO_X4: return integrar<Xoshiro256x4>(f, dominio, samples, politica);
+	case GEN_XOSHIRO_X8: return integrar<Xoshiro256x8>(f, dominio, samples, politica);
+	case GEN_XOSHIRO_X16: return integrar<Xoshiro256x16>(f, dominio, samples, politica);
+	case GEN_AES_CTR: return integrar<AesCtr>(f, dominio, samples, politica);
+	default: return integrar<std::mt19937>(f, dominio, samples, politica);
+	}
+}
+
+/**
+ * Estima π con el integrador genérico
+ *
+ * @param samples: Número de puntos
+ * @param opciones: Hilos, tamaño de chunk, generador y semilla
+ */
+ResultadoMontecarlo montecarlo_integrador(long long samples, const OpcionesParalelo& opciones) {
+	ResultadoMontecarlo resultado;
+	const Dominio<2> cuadrado = { { 0.0, 0.0 }, { 1.0, 1.0 } };
+	PoliticaIntegracion politica;
+	politica.num_hilos = opciones.num_hilos;
+	politica.bloques_por_chunk = opciones.bloques_por_chunk;
+	politica.semilla = obtener_semilla(opciones);
+
+	ResultadoIntegral integral = integrar_con_generador(opciones.generador, IntegrandoCuartoCirculo(),
+		cuadrado, samples, politica);
+
+	resultado.samples = samples;
+	resultado.es_paralelo = true;
+	resultado.metodo = "Integrador";
+	resultado.num_hilos = opciones.num_hilos;
+	resultado.suma = integral.suma / 4.0;  // Aciertos
+	resultado.semilla = politica.semilla;
+	resultado.cancelado = false;
+	resultado.bits_coordenada = std::numeric_limits<double>::digits;
+	resultado.pi = integral.valor;
+	resultado.tiempo_segundos = integral.tiempo_segundos;
+	resultado.tiempo_ms = integral.tiempo_segundos * 1e3;
+	resultado.tiempo_us = integral.tiempo_segundos * 1e6;
+	calcular_errores(resultado, integral.error_estandar);
+
+	printf("----------------Integrador generico (pi)----------------\n");
+	printf("Generador: %s/double, integrando por lotes\n", NOMBRES_GENERADOR[opciones.generador]);
+	printf("Numero de Hilos utilizados: %d\n", opciones.num_hilos);
+	printf("Numero de Samples = %lld\n", samples);
+	printf("Semilla = %llu\n", politica.semilla);
+	printf("pi = %.12f +- %.3e\n", resultado.pi, integral.error_estandar);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+// Integra la expresión sobre [0, 1]^D con D fijo al compilar
+template <int D>
+static ResultadoIntegral integrar_expresion_cubo(const ExpresionCompilada& expresion, long long samples,
+	const OpcionesParalelo& opciones, const PoliticaIntegracion& politica) {
+	Dominio<D> cubo;
+	for (int d = 0; d < D; ++d) {
+		cubo.inferior[d] = 0.0;
+		cubo.superior[d] = 1.0;
+	}
+	ExpresionCompilada f = expresion;
+	f.fijar_paso(D);
+	return integrar_con_generador(opciones.generador, f, cubo, samples, politica);
+}
+
+/**
+ * Integra sobre [0, 1]^D una expresión dada como texto, con el integrador
+ * genérico y el código de bytes de expresion_integrando.h. D es el número de
+ * coordenadas que usa la expresión (al menos 1).
+ *
+ * @return false si la expresión no compila
+ */
+bool integrar_expresion(const char* texto, long long samples, const OpcionesParalelo& opciones) {
+	ExpresionCompilada expresion;
+	std::string error;
+	if (!expresion.compilar(texto, error)) {
+		printf("Error: No se pudo compilar el integrando \"%s\": %s\n", texto, error.c_str());
+		return false;
+	}
+
+	PoliticaIntegracion politica;
+	politica.num_hilos = opciones.num_hilos;
+	politica.bloques_por_chunk = opciones.bloques_por_chunk;
+	politica.semilla = obtener_semilla(opciones);
+
+	int dimension = expresion.dimension() > 0 ? expresion.dimension() : 1;
+	ResultadoIntegral integral;
+	switch (dimension) {
+	case 1: integral = integrar_expresion_cubo<1>(expresion, samples, opciones, politica); break;
+	case 2: integral = integrar_expresion_cubo<2>(expresion, samples, opciones, politica); break;
+	case 3: integral = integrar_expresion_cubo<3>(expresion, samples, opciones, politica); break;
+	case 4: integral = integrar_expresion_cubo<4>(expresion, samples, opciones, politica); break;
+	case 5: integral = integrar_expresion_cubo<5>(expresion, samples, opciones, politica); break;
+	case 6: integral = integrar_expresion_cubo<6>(expresion, samples, opciones, politica); break;
+	case 7: integral = integrar_expresion_cubo<7>(expresion, samples, opciones, politica); break;
+	default: integral = integrar_expresion_cubo<8>(expresion, samples, opciones, politica); break;
+	}
+
+	printf("----------------Integrando en tiempo de ejecucion----------------\n");
+	printf("f = %s sobre [0,1]^%d (%d instrucciones)\n", texto, dimension, expresion.instrucciones());
+	printf("Generador: %s/double\n", NOMBRES_GENERADOR[opciones.generador]);
+	printf("Numero de Hilos utilizados: %d\n", opciones.num_hilos);
+	printf("Numero de Samples = %lld\n", samples);
+	printf("Semilla = %llu\n", politica.semilla);
+	printf("Integral = %.12f +- %.3e\n", integral.valor, integral.error_estandar);
+	printf("Rendimiento = %.2f Msamples/s\n", samples / integral.tiempo_segundos * 1e-6);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", integral.tiempo_segundos * 1e3);
+	printf("-------------------------------------------------------------------\n\n");
+	return true;
+}
+
+/**
+ * RÉPLICAS INDEPENDIENTES
+ *
+ * R estimaciones de N muestras cada una, para ver la dispersión real de la
+ * estimación en lugar de fiarse solo del error estándar teórico. La réplica r
+ * usa los bloques [r·B, (r+1)·B) de la secuencia de la semilla (B = bloques de
+ * N muestras): son subflujos disjuntos, y la réplica 0 coincide con
+ * montecarlo_paralelo(N) con la misma semilla. Los R·B bloques se reparten
+ * juntos entre los hilos en una sola región paralela, así que con N pequeño no
+ * se paga R veces la creación del equipo de hilos ni quedan hilos parados al
+ * final de cada réplica.
+ */
+const char* const ARCHIVO_REPLICAS = "replicas_montecarlo.csv";
+
+struct ResultadoReplicas {
+	long long samples;           // Muestras de cada réplica
+	int replicas;
+	int num_hilos;
+	unsigned long long semilla;
+	double media;                // Media de las R estimaciones
+	double desviacion;           // Desviación típica muestral entre réplicas
+	double minimo;
+	double maximo;
+	double error_teorico;        // Error estándar teórico de una réplica
+	double tiempo_segundos;      // Tiempo de las R réplicas
+};
+
+/**
+ * Ejecuta R réplicas con el núcleo de la versión paralela
+ *
+ * @param samples: Muestras de cada réplica
+ * @param replicas: Número de réplicas (R >= 2)
+ * @param opciones: Hilos, tamaño de chunk, núcleo y semilla
+ */
+ResultadoReplicas montecarlo_replicas(long long samples, int replicas, const OpcionesParalelo& opciones) {
+	ResultadoReplicas resultado;
+	const EntradaNucleo* nucleo = seleccionar_nucleo(opciones);
+	unsigned long long seed_base = obtener_semilla(opciones);
+	long long bloques = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	long long unidades = bloques * replicas;
+	PoliticaIntegracion politica;
+	politica.num_hilos = opciones.num_hilos;
+	politica.bloques_por_chunk = opciones.bloques_por_chunk;
+
+	// La unidad u es el bloque u mod B de la réplica u / B, y el bloque u de la
+	// secuencia de la semilla
+	double inicio = omp_get_wtime();
+	std::vector<double> sumas = sumar_por_bloques<double>(unidades, politica,
+		[nucleo, seed_base, samples, bloques](long long u, double& suma_unidad) {
+			long long desde = u * MUESTRAS_POR_BLOQUE;
+			suma_unidad = nucleo->sumar(seed_base, u, desde, desde + muestras_bloque(samples, u % bloques));
+		});
+
+	// Estimación de cada réplica (sumas en orden de bloque) y estadísticos
+	std::vector<double> estimaciones(replicas);
+	double suma = 0.0;
+	for (int r = 0; r < replicas; r++) {
+		double suma_replica = combinar_bloques(sumas, r * bloques, (r + 1) * bloques);
+		estimaciones[r] = nucleo->a_pi(suma_replica, samples);
+		suma += estimaciones[r];
+	}
+	resultado.tiempo_segundos = omp_get_wtime() - inicio;
+
+	resultado.media = suma / replicas;
+	double cuadrados = 0.0;
+	for (double e : estimaciones) {
+		cuadrados += (e - resultado.media) * (e - resultado.media);
+	}
+	resultado.desviacion = replicas > 1 ? sqrt(cuadrados / (replicas - 1)) : 0.0;
+	resultado.minimo = *std::min_element(estimaciones.begin(), estimaciones.end());
+	resultado.maximo = *std::max_element(estimaciones.begin(), estimaciones.end());
+	resultado.error_teorico = nucleo->error_estandar(resultado.media, samples);
+	resultado.samples = samples;
+	resultado.replicas = replicas;
+	resultado.num_hilos = opciones.num_hilos;
+	resultado.semilla = seed_base;
+
+	printf("----------------Replicas independientes----------------\n");
+	printf("Nucleo: %s/%s/%s, %s\n", NOMBRES_ESTIMADOR[opciones.estimador],
+		NOMBRES_GENERADOR[opciones.generador], NOMBRES_PRECISION[opciones.precision],
+		describir_variante(opciones).c_str());
+	printf("Numero de Hilos utilizados: %d\n", opciones.num_hilos);
+	printf("Replicas = %d de %lld samples\n", replicas, samples);
+	printf("Semilla = %llu\n", seed_base);
+	printf("Media = %.12f (error %.3e)\n", resultado.media, fabs(resultado.media - referencia_pi().alto));
+	printf("Desviacion entre replicas = %.3e (teorica %.3e)\n", resultado.desviacion, resultado.error_teorico);
+	printf("Minimo = %.12f, maximo = %.12f\n", resultado.minimo, resultado.maximo);
+	printf("Tiempo de las %d replicas (en segundos) => %.12lf s\n", replicas, resultado.tiempo_segundos);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * PASADA CONJUNTA: ACIERTO-FALLO, VALOR MEDIO Y ANTITÉTICO
+ *
+ * Los tres estimadores de sumar_bloque_conjunto sobre los mismos puntos. Cada
+ * uno da su fila del CSV (con el tiempo de la pasada completa), y por pantalla
+ * se comparan sus varianzas y la de sus diferencias, con números aleatorios
+ * comunes frente a flujos independientes.
+ */
+const char* const METODOS_CONJUNTOS[] = { "Conjunto aciertos", "Conjunto valor medio", "Conjunto antitetico" };
+
+/**
+ * Ejecuta la pasada conjunta
+ *
+ * @param samples: Número de puntos (cada uno alimenta a los tres estimadores)
+ * @param opciones: Hilos, tamaño de chunk, generador y semilla
+ * @return Un resultado por estimador, en el orden de EstimadorConjunto
+ */
+std::vector<ResultadoMontecarlo> montecarlo_conjunto(long long samples, const OpcionesParalelo& opciones) {
+	const int E = NUM_ESTIMADORES_CONJUNTOS;
+	FuncionBloqueConjunto sumar_bloque = buscar_conjunto(opciones.generador)->sumar;
+	unsigned long long seed_base = obtener_semilla(opciones);
+	long long bloques = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	PoliticaIntegracion politica;
+	politica.num_hilos = opciones.num_hilos;
+	politica.bloques_por_chunk = opciones.bloques_por_chunk;
+
+	// Sumas de cada bloque, combinadas en orden de bloque: el resultado no
+	// depende del número de hilos
+	double inicio = omp_get_wtime();
+	std::vector<SumasConjuntas> por_bloque = sumar_por_bloques<SumasConjuntas>(bloques, politica,
+		[sumar_bloque, seed_base, samples](long long b, SumasConjuntas& s) {
+			sumar_bloque(seed_base, b, muestras_bloque(samples, b), s);
+		});
+	SumasConjuntas total = combinar_bloques(por_bloque, 0, bloques);
+	double tiempo = omp_get_wtime() - inicio;
+
+	// Covarianzas de una muestra, en unidades de π (cada estimador vale 4·f)
+	double media[E], covarianza[E][E];
+	for (int i = 0; i < E; i++) {
+		media[i] = total.suma[i] / samples;
+	}
+	for (int i = 0; i < E; i++) {
+		for (int j = 0; j < E; j++) {
+			covarianza[i][j] = samples > 1
+				? 16.0 * (total.productos[i][j] - total.suma[i] * media[j]) / (samples - 1) : 0.0;
+		}
+	}
+
+	std::vector<ResultadoMontecarlo> resultados(E);
+	for (int i = 0; i < E; i++) {
+		ResultadoMontecarlo& r = resultados[i];
+		r.samples = samples;
+		r.es_paralelo = true;
+		r.metodo = METODOS_CONJUNTOS[i];
+		r.num_hilos = opciones.num_hilos;
+		r.suma = total.suma[i];
+		r.semilla = seed_base;
+		r.cancelado = false;
+		r.bits_coordenada = std::numeric_limits<double>::digits;
+		r.pi = 4.0 * media[i];
+		r.tiempo_segundos = tiempo;
+		r.tiempo_ms = tiempo * 1e3;
+		r.tiempo_us = tiempo * 1e6;
+		// Sin varianza (menos de 2 muestras o estimador constante) el error estándar
+		// es 0 y calcular_errores deja z sin valor
+		calcular_errores(r, covarianza[i][i] > 0.0 ? sqrt(covarianza[i][i] / samples) : 0.0);
+	}
+
+	printf("----------------Pasada conjunta (numeros aleatorios comunes)----------------\n");
+	printf("Generador: %s/double\n", NOMBRES_GENERADOR[opciones.generador]);
+	printf("Numero de Hilos utilizados: %d\n", opciones.num_hilos);
+	printf("Numero de Samples = %lld (los mismos puntos para los %d estimadores)\n", samples, E);
+	printf("Semilla = %llu\n", seed_base);
+	// Los cocientes entre varianzas solo se muestran si no dividen por cero
+	for (int i = 0; i < E; i++) {
+		char mejora[32] = "n/a";
+		if (covarianza[i][i] > 0.0) {
+			snprintf(mejora, sizeof(mejora), "x%.1f", covarianza[CONJ_ACIERTOS][CONJ_ACIERTOS] / covarianza[i][i]);
+		}
+		printf("%-12s pi = %.12f, varianza/muestra = %.6f (%s frente a aciertos)\n", NOMBRES_CONJUNTOS[i],
+			resultados[i].pi, covarianza[i][i], mejora);
+		printf("             ");
+		imprimir_error(resultados[i]);
+	}
+	printf("Diferencias (error estandar con CRN / con flujos independientes):\n");
+	for (int i = 0; i < E; i++) {
+		for (int j = i + 1; j < E; j++) {
+			double comun = covarianza[i][i] + covarianza[j][j] - 2.0 * covarianza[i][j];
+			double independiente = covarianza[i][i] + covarianza[j][j];
+			char correlacion[32] = "n/a";
+			if (covarianza[i][i] > 0.0 && covarianza[j][j] > 0.0) {
+				snprintf(correlacion, sizeof(correlacion), "%.3f",
+					covarianza[i][j] / sqrt(covarianza[i][i] * covarianza[j][j]));
+			}
+			printf("  %s - %s = %.3e, e.e. %.3e / %.3e (correlacion %s)\n", NOMBRES_CONJUNTOS[i],
+				NOMBRES_CONJUNTOS[j], resultados[i].pi - resultados[j].pi,
+				sqrt(std::max(comun, 0.0) / samples), sqrt(std::max(independiente, 0.0) / samples), correlacion);
+		}
+	}
+	printf("Tiempo de la pasada (en segundos) => %.12lf s\n", tiempo);
+	printf("Tiempo de la pasada (en milisegundos) => %.8lf ms\n", tiempo * 1e3);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultados;
+}
+
+/**
+ * VALORACIÓN DE OPCIONES
+ *
+ * Precio de una call europea o asiática geométrica simulando caminos del
+ * subyacente (valoracion_opciones.h), comparado con su precio exacto. El
+ * resultado va al CSV como cualquier otro, con el precio en la columna del valor.
+ */
+const char* const METODOS_OPCION[] = { "Opcion europea", "Opcion asiatica" };
+
+// Instancia valorar_opcion con el generador pedido en tiempo de ejecución
+static ResultadoIntegral valorar_con_generador(int generador, const ContratoOpcion& contrato,
+	long long caminos, const PoliticaIntegracion& politica, int metodo_normal) {
+	switch (generador) {
+	case GEN_MT19937_64: return valorar_opcion<std::mt19937_64>(contrato, caminos, politica, metodo_normal);
+	case GEN_XOSHIRO_X4: return valorar_opcion<Xoshiro256x4>(contrato, caminos, politica, metodo_normal);
+	case GEN_XOSHIRO_X8: return valorar_opcion<Xoshiro256x8>(contrato, caminos, politica, metodo_normal);
+	case GEN_XOSHIRO_X16: return valorar_opcion<Xoshiro256x16>(contrato, caminos, politica, metodo_normal);
+	case GEN_AES_CTR: return valorar_opcion<AesCtr>(contrato, caminos, politica, metodo_normal);
+	default: return valorar_opcion<std::mt19937>(contrato, caminos, politica, metodo_normal);
+	}
+}
+
+/**
+ * Valora el contrato con el motor paralelo
+ *
+ * @param caminos: Número de caminos simulados
+ * @param contrato: Tipo de opción y parámetros del modelo
+ * @param opciones: Hilos, tamaño de chunk, generador, normales y semilla
+ */
+ResultadoMontecarlo montecarlo_opcion(long long caminos, const ContratoOpcion& contrato,
+	const OpcionesParalelo& opciones) {
+	ResultadoMontecarlo resultado;
+	PoliticaIntegracion politica;
+	politica.num_hilos = opciones.num_hilos;
+	politica.bloques_por_chunk = opciones.bloques_por_chunk;
+	politica.semilla = obtener_semilla(opciones);
+
+	ResultadoIntegral precio = valorar_con_generador(opciones.generador, contrato, caminos, politica,
+		opciones.metodo_normal);
+	double exacto = precio_exacto_opcion(contrato);
+
+	resultado.samples = caminos;
+	resultado.es_paralelo = true;
+	resultado.metodo = METODOS_OPCION[contrato.tipo];
+	resultado.num_hilos = opciones.num_hilos;
+	resultado.suma = precio.suma;
+	resultado.semilla = politica.semilla;
+	resultado.cancelado = false;
+	resultado.bits_coordenada = std::numeric_limits<double>::digits;
+	resultado.pi = precio.valor;
+	resultado.tiempo_segundos = precio.tiempo_segundos;
+	resultado.tiempo_ms = precio.tiempo_segundos * 1e3;
+	resultado.tiempo_us = precio.tiempo_segundos * 1e6;
+	calcular_errores(resultado, precio.error_estandar, exacto);
+
+	printf("----------------%s----------------\n", resultado.metodo);
+	printf("Generador: %s/double, normales con %s\n", NOMBRES_GENERADOR[opciones.generador],
+		NOMBRES_NORMAL[opciones.metodo_normal]);
+	printf("S = %g, K = %g, r = %g, sigma = %g, T = %g", contrato.spot, contrato.strike,
+		contrato.tasa, contrato.volatilidad, contrato.vencimiento);
+	if (contrato.tipo == OPCION_ASIATICA) {
+		printf(", %d observaciones", contrato.pasos);
+	}
+	printf("\n");
+	printf("Numero de Hilos utilizados: %d\n", opciones.num_hilos);
+	printf("Numero de caminos = %lld\n", caminos);
+	printf("Semilla = %llu\n", politica.semilla);
+	printf("Precio = %.8f +- %.3e (exacto %.8f)\n", resultado.pi, precio.error_estandar, exacto);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * AGUJA DE BUFFON Y BUFFON-LAPLACE
+ *
+ * Otros estimadores geométricos de π sobre el mismo motor paralelo, con una
+ * mezcla de operaciones distinta (rechazo y más coordenadas por muestra) para
+ * comparar generadores y repartos. Los núcleos están en nucleos_montecarlo.h.
+ */
+const char* const METODOS_BUFFON[] = { "Buffon", "Buffon-Laplace" };
+
+/**
+ * Estima π con el experimento opciones.experimento_buffon
+ *
+ * @param samples: Número de agujas (candidatos de dirección aceptados)
+ * @param opciones: Hilos, reparto, generador, semilla y control
+ * @return ResultadoMontecarlo con suma = número de cruces
+ */
+ResultadoMontecarlo montecarlo_buffon(long long samples, const OpcionesParalelo& opciones) {
+	ResultadoMontecarlo resultado;
+	const EntradaBuffon* entrada = buscar_buffon(opciones.generador, opciones.experimento_buffon);
+	unsigned long long seed_base = obtener_semilla(opciones);
+	long long hechas = 0;
+
+	ControlEjecucion* control = opciones.control;
+	if (control != nullptr) {
+		control->bloques_totales = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+		control->bloques_hechos.store(0);
+		control->siguiente_aviso = control->bloques_entre_avisos;
+	}
+	double inicio = omp_get_wtime();
+	double cruces = contar_rango_paralelo(seed_base, 0, samples, opciones, hechas);
+	double total = omp_get_wtime() - inicio;
+
+	resultado.samples = hechas;
+	resultado.es_paralelo = true;
+	resultado.metodo = METODOS_BUFFON[opciones.experimento_buffon];
+	resultado.num_hilos = hilos_efectivos(0, samples, opciones.num_hilos);
+	resultado.suma = cruces;
+	resultado.semilla = seed_base;
+	resultado.cancelado = hechas < samples;
+	resultado.bits_coordenada = std::numeric_limits<double>::digits;
+	resultado.pi = hechas > 0 ? entrada->a_pi(cruces, hechas) : 0.0;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, hechas > 0 ? entrada->error_estandar(resultado.pi, hechas) : 0.0);
+
+	printf("----------------%s----------------\n", resultado.metodo);
+	printf("Generador: %s/double\n", NOMBRES_GENERADOR[opciones.generador]);
+	printf("Numero de Hilos utilizados: %d\n", resultado.num_hilos);
+	printf("Numero de Samples = %lld\n", samples);
+	if (resultado.cancelado) {
+		printf("Ejecucion CANCELADA tras %lld samples\n", hechas);
+	}
+	printf("Semilla = %llu\n", seed_base);
+	printf("Cruces = %.0f\n", cruces);
+	printf("pi = %.12f\n", resultado.pi);
+	imprimir_error(resultado);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * VOLUMEN DE LA BOLA UNIDAD EN D DIMENSIONES
+ *
+ * Mismo motor paralelo (bloques, semillas, reparto y cancelación) con el núcleo
+ * de la bola de nucleos_montecarlo.h (muestreo por importancia con propuesta
+ * gaussiana, que funciona igual en D = 2 que en D = 32), y de él se despeja π.
+ * Los pesos no son binomiales, así que el error estándar sale de la dispersión
+ * de las medias de LOTES_INTERVALO lotes (ver SumasLotes); con menos de
+ * MUESTRAS_MIN_INTERVALOS muestras no hay error estándar.
+ */
+
+// Nombre del método en el CSV ("Bola-5D", ...)
+static const char* nombre_bola(int dimension) {
+	static std::vector<std::string> nombres;
+	if (nombres.empty()) {
+		for (int d = 0; d <= DIMENSION_MAX_BOLA; ++d) {
+			nombres.push_back("Bola-" + std::to_string(d) + "D");
+		}
+	}
+	return nombres[dimension].c_str();
+}
+
+/**
+ * Estima el volumen de la bola unidad de dimensión opciones.dimension_bola
+ *
+ * @param samples: Número de puntos de [0, 1]^D
+ * @param opciones: Hilos, reparto, generador, semilla y control (la precisión es siempre double)
+ * @return ResultadoMontecarlo con el π derivado del volumen; suma = suma de los
+ *         pesos sin constante_bola(D) (0 si ningún punto cayó dentro de la bola)
+ */
+ResultadoMontecarlo montecarlo_bola(long long samples, const OpcionesParalelo& opciones) {
+	ResultadoMontecarlo resultado;
+	const int D = opciones.dimension_bola;
+	unsigned long long seed_base = obtener_semilla(opciones);
+	long long hechas = 0;
+
+	ControlEjecucion* control = opciones.control;
+	if (control != nullptr) {
+		control->bloques_totales = (samples + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+		control->bloques_hechos.store(0);
+		control->siguiente_aviso = control->bloques_entre_avisos;
+	}
+	// Sumas por lotes para el error estándar
+	OpcionesParalelo efectivas = opciones;
+	SumasLotes lotes;
+	if (samples >= MUESTRAS_MIN_INTERVALOS) {
+		lotes.hasta = samples;
+		efectivas.lotes = &lotes;
+	}
+
+	double inicio = omp_get_wtime();
+	double suma = contar_rango_paralelo(seed_base, 0, samples, efectivas, hechas);
+	double total = omp_get_wtime() - inicio;
+
+	// Volumen = constante · media de los pesos. Su error estándar es el de la media
+	// de los lotes (si están todos completos), y pasa a π por la derivada de V^(2/D)
+	double escala = constante_bola(D);
+	double volumen = hechas > 0 ? escala * suma / hechas : 0.0;
+	double error_volumen = 0.0;
+	if (efectivas.lotes != nullptr && hechas == samples) {
+		double medias[LOTES_INTERVALO], media = 0.0, cuadrados = 0.0;
+		for (int k = 0; k < LOTES_INTERVALO; k++) {
+			medias[k] = escala * lotes.suma[k] / lotes.muestras[k];
+			media += medias[k] / LOTES_INTERVALO;
+		}
+		for (double m : medias) {
+			cuadrados += (m - media) * (m - media);
+		}
+		error_volumen = sqrt(cuadrados / (LOTES_INTERVALO - 1) / LOTES_INTERVALO);
+	}
+
+	resultado.samples = hechas;
+	resultado.es_paralelo = true;
+	resultado.metodo = nombre_bola(D);
+	resultado.num_hilos = hilos_efectivos(0, samples, opciones.num_hilos);
+	resultado.suma = suma;
+	resultado.semilla = seed_base;
+	resultado.cancelado = hechas < samples;
+	resultado.bits_coordenada = std::numeric_limits<double>::digits;
+	resultado.pi = volumen > 0 ? pi_desde_volumen(D, volumen) : 0.0;
+	resultado.tiempo_segundos = total;
+	resultado.tiempo_ms = total * 1e3;
+	resultado.tiempo_us = total * 1e6;
+	calcular_errores(resultado, volumen > 0 ? 2.0 / D * resultado.pi * error_volumen / volumen : 0.0);
+
+	printf("----------------Volumen de la bola unidad----------------\n");
+	printf("Dimension = %d\n", D);
+	printf("Generador: %s/double\n", NOMBRES_GENERADOR[opciones.generador]);
+	printf("Numero de Hilos utilizados: %d\n", resultado.num_hilos);
+	printf("Numero de Samples = %lld\n", samples);
+	if (resultado.cancelado) {
+		printf("Ejecucion CANCELADA tras %lld samples\n", hechas);
+	}
+	printf("Semilla = %llu\n", seed_base);
+	printf("Volumen = %.12e +- %.3e (exacto %.12e)\n", volumen, error_volumen,
+		volumen_bola(D, referencia_pi().alto));
+	if (volumen > 0) {
+		printf("pi derivado = %.12f\n", resultado.pi);
+		imprimir_error(resultado);
+		if (error_volumen == 0.0) {
+			printf("Sin error estandar: hacen falta al menos %lld samples\n", MUESTRAS_MIN_INTERVALOS);
+		}
+	}
+	else {
+		printf("Ningun punto cayo dentro de la bola: hacen falta mas samples\n");
+	}
+	printf("Rendimiento = %.2f Msamples/s (%.2f Mcoordenadas/s)\n",
+		hechas / total * 1e-6, (double)hechas * D / total * 1e-6);
+	printf("Tiempo de ejec./elemento de calculo (en segundos) => %.12lf s\n", resultado.tiempo_segundos);
+	printf("Tiempo de ejec./elemento de calculo (en milisegundos) => %.8lf ms\n", resultado.tiempo_ms);
+	printf("Tiempo de ejec./elemento de calculo (en microsegundos) => %.8lf us\n", resultado.tiempo_us);
+	printf("-------------------------------------------------------------------\n\n");
+
+	return resultado;
+}
+
+/**
+ * AUTOTUNER DEL NÚCLEO PARALELO
+ *
+ * Busca en esta máquina la configuración más rápida del núcleo (hilos, tipo de
+ * reparto, bloques por chunk, generador, precisión, variante del bucle y su
+ * parámetro: desenrollado, tamaño del búfer o flujos intercalados) midiendo la
+ * carga de trabajo del benchmark. La búsqueda es por coordenadas: se recorre
+ * cada dimensión probando todos sus valores con el resto fijo en el mejor
+ * encontrado hasta el momento, lo que evita medir el producto cartesiano completo.
+ * El ganador se guarda en un archivo indexado por modelo de CPU y número de
+ * procesadores, y montecarlo_paralelo lo usa por defecto (ver cargar_autotune).
+ *
+ * Cambiar el generador, la precisión o la variante cambia la secuencia de puntos (no su
+ * calidad estadística); ambos quedan anotados en checkpoints y registros.
+ */
+
+// Identificador de la máquina para el archivo de autotune: modelo de CPU y
+// número de procesadores, sin espacios (el archivo separa campos por espacios)
+std::string clave_maquina() {
+	std::string modelo;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int registros[4];
+	char marca[49] = { 0 };
+	__cpuid(registros, 0x80000000);
+	if ((unsigned int)registros[0] >= 0x80000004u) {
+		for (int k = 0; k < 3; k++) {
+			__cpuid(reinterpret_cast<int*>(marca + 16 * k), 0x80000002 + k);
+		}
+		modelo = marca;
+	}
+#elif defined(__x86_64__) || defined(__i386__)
+	unsigned int registros[4];
+	char marca[49] = { 0 };
+	if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000004u) {
+		for (unsigned int k = 0; k < 3; k++) {
+			__get_cpuid(0x80000002 + k, &registros[0], &registros[1], &registros[2], &registros[3]);
+			memcpy(marca + 16 * k, registros, sizeof(registros));
+		}
+		modelo = marca;
+	}
+#endif
+	if (modelo.empty()) {
+		modelo = "cpu_desconocida";
+	}
+
+	// Compactar espacios en '_'
+	std::string clave;
+	for (char c : modelo) {
+		if (c == ' ') {
+			if (!clave.empty() && clave.back() != '_') clave += '_';
+		}
+		else {
+			clave += c;
+		}
+	}
+	if (!clave.empty() && clave.back() == '_') clave.pop_back();
+	return clave + "_x" + std::to_string(omp_get_num_procs());
+}
+
+// Mediana de tres ejecuciones del benchmark con la configuración dada
+static double medir_configuracion(long long samples, const OpcionesParalelo& opciones) {
+	double tiempos[3];
+	for (int r = 0; r < 3; r++) {
+		double inicio = omp_get_wtime();
+		contar_rango_paralelo(12345 + r, 0, samples, opciones);
+		tiempos[r] = omp_get_wtime() - inicio;
+	}
+	std::sort(tiempos, tiempos + 3);
+	return tiempos[1];
+}
+
+static void mostrar_configuracion(const OpcionesParalelo& o) {
+	printf("hilos %d, reparto %s,%d, %s/%s, %s", o.num_hilos,
+		NOMBRES_PLANIFICACION[o.planificacion], o.bloques_por_chunk,
+		NOMBRES_GENERADOR[o.generador], NOMBRES_PRECISION[o.precision], describir_variante(o).c_str());
+}
+
+/**
+ * Ejecuta la búsqueda por coordenadas y devuelve la mejor configuración
+ *
+ * @param samples: Tamaño del benchmark usado en cada medición
+ * @param base: Configuración de partida (también se conservan su semilla y control)
+ */
+OpcionesParalelo autotune(long long samples, const OpcionesParalelo& base) {
+	OpcionesParalelo mejor = base;
+	double mejor_tiempo = medir_configuracion(samples, mejor);
+
+	// Candidatos de número de hilos: potencias de 2 hasta el doble de
+	// procesadores, más el número de procesadores y el valor de partida
+	std::vector<int> hilos;
+	int procesadores = omp_get_num_procs();
+	for (int h = 1; h <= 2 * procesadores || h <= base.num_hilos; h *= 2) hilos.push_back(h);
+	hilos.push_back(procesadores);
+	hilos.push_back(base.num_hilos);
+	std::sort(hilos.begin(), hilos.end());
+	hilos.erase(std::unique(hilos.begin(), hilos.end()), hilos.end());
+
+	std::vector<int> chunks = { 1, 2, 4, 8, 16 };
+	std::vector<int> planificaciones, generadores, precisiones, desenrollados, variantes, bufers, flujos;
+	for (int k = 0; k < NUM_PLANIFICACIONES; k++) planificaciones.push_back(k);
+	for (int k = 0; k < NUM_GENERADORES; k++) generadores.push_back(k);
+	for (int k = 0; k < NUM_PRECISIONES; k++) precisiones.push_back(k);
+	for (int k = 0; k < NUM_DESENROLLADOS; k++) desenrollados.push_back(DESENROLLADOS[k]);
+	for (int k = 0; k < NUM_VARIANTES; k++) variantes.push_back(k);
+	for (int k = 0; k < NUM_TAMANOS_BUFER; k++) bufers.push_back(TAMANOS_BUFER[k]);
+	for (int k = 0; k < NUM_FLUJOS_ILP; k++) flujos.push_back(FLUJOS_ILP[k]);
+
+	struct Dimension {
+		const char* nombre;
+		int OpcionesParalelo::* campo;
+		const std::vector<int>* valores;
+	};
+	const Dimension dimensiones[] = {
+		{ "hilos", &OpcionesParalelo::num_hilos, &hilos },
+		{ "reparto", &OpcionesParalelo::planificacion, &planificaciones },
+		{ "chunk", &OpcionesParalelo::bloques_por_chunk, &chunks },
+		{ "generador", &OpcionesParalelo::generador, &generadores },
+		{ "precision", &OpcionesParalelo::precision, &precisiones },
+		{ "desenrollado", &OpcionesParalelo::desenrollado, &desenrollados },
+		{ "variante", &OpcionesParalelo::variante, &variantes },
+		{ "bufer", &OpcionesParalelo::palabras_bufer, &bufers },
+		{ "flujos", &OpcionesParalelo::flujos_ilp, &flujos },
+	};
+
+	printf("Autotune con %lld samples por medicion en %s\n", samples, clave_maquina().c_str());
+	for (const Dimension& d : dimensiones) {
+		for (int valor : *d.valores) {
+			if (mejor.*d.campo == valor) continue;
+			OpcionesParalelo candidata = mejor;
+			candidata.*d.campo = valor;
+			if (buscar_nucleo_exacto(candidata) == nullptr) continue;  // Combinación no instanciada
+			double t = medir_configuracion(samples, candidata);
+			printf("  [%s] ", d.nombre);
+			mostrar_configuracion(candidata);
+			printf(" => %.3f ms\n", t * 1e3);
+			if (t < mejor_tiempo) {
+				mejor_tiempo = t;
+				mejor = candidata;
+			}
+		}
+	}
+
+	printf("Mejor configuracion: ");
+	mostrar_configuracion(mejor);
+	printf(" (%.3f ms)\n\n", mejor_tiempo * 1e3);
+	return mejor;
+}
+
+/**
+ * Guarda la configuración de esta máquina en el archivo de autotune,
+ * conservando las de otras máquinas que ya estuvieran en él
+ */
+bool guardar_autotune(const char* nombre_archivo, const OpcionesParalelo& o) {
+	std::map<std::string, std::string> valores;
+	if (std::filesystem::exists(nombre_archivo)) {
+		leer_archivo_estado(nombre_archivo, "montecarlo_autotune", 1, {}, valores);
+	}
+
+	std::string clave = clave_maquina();
+	valores[clave + ".hilos"] = std::to_string(o.num_hilos);
+	valores[clave + ".reparto"] = NOMBRES_PLANIFICACION[o.planificacion];
+	valores[clave + ".chunk"] = std::to_string(o.bloques_por_chunk);
+	valores[clave + ".generador"] = NOMBRES_GENERADOR[o.generador];
+	valores[clave + ".precision"] = NOMBRES_PRECISION[o.precision];
+	valores[clave + ".desenrollado"] = std::to_string(o.desenrollado);
+	valores[clave + ".variante"] = NOMBRES_VARIANTE[o.variante];
+	valores[clave + ".bufer"] = std::to_string(o.palabras_bufer);
+	valores[clave + ".flujos"] = std::to_string(o.flujos_ilp);
+
+	std::string contenido = "montecarlo_autotune 1\n";
+	for (const auto& par : valores) {
+		contenido += par.first + " " + par.second + "\n";
+	}
+	return escribir_archivo_atomico(nombre_archivo, contenido);
+}
+
+/**
+ * Aplica a 'o' la configuración guardada para esta máquina, si existe
+ *
+ * @return true si había una configuración válida para esta máquina
+ */
+bool cargar_autotune(const char* nombre_archivo, OpcionesParalelo& o) {
+	std::map<std::string, std::string> valores;
+	std::string clave = clave_maquina();
+	if (!std::filesystem::exists(nombre_archivo) ||
+		!leer_archivo_estado(nombre_archivo, "montecarlo_autotune", 1, {}, valores) ||
+		valores.find(clave + ".desenrollado") == valores.end()) {
+		return false;
+	}
+
+	// Se lee sobre una copia: con cualquier valor no válido se ignora la entrada
+	// entera y se siguen usando las opciones de partida
+	OpcionesParalelo leidas = o;
+	leidas.planificacion = buscar_nombre(NOMBRES_PLANIFICACION, NUM_PLANIFICACIONES, valores[clave + ".reparto"]);
+	leidas.generador = buscar_nombre(NOMBRES_GENERADOR, NUM_GENERADORES, valores[clave + ".generador"]);
+	leidas.precision = buscar_nombre(NOMBRES_PRECISION, NUM_PRECISIONES, valores[clave + ".precision"]);
+	bool valida = leidas.planificacion >= 0 && leidas.generador >= 0 && leidas.precision >= 0 &&
+		leer_numero(valores[clave + ".hilos"], leidas.num_hilos) && leidas.num_hilos >= 1 &&
+		leer_numero(valores[clave + ".chunk"], leidas.bloques_por_chunk) && leidas.bloques_por_chunk >= 1 &&
+		leer_numero(valores[clave + ".desenrollado"], leidas.desenrollado) &&
+		std::count(DESENROLLADOS, DESENROLLADOS + NUM_DESENROLLADOS, leidas.desenrollado) > 0;
+
+	// Archivos anteriores a la variante con búfer no tienen estas claves
+	int variante = buscar_nombre(NOMBRES_VARIANTE, NUM_VARIANTES, valores[clave + ".variante"]);
+	if (valida && variante >= 0 && valores.find(clave + ".bufer") != valores.end()) {
+		leidas.variante = variante;
+		valida = leer_numero(valores[clave + ".bufer"], leidas.palabras_bufer) &&
+			std::count(TAMANOS_BUFER, TAMANOS_BUFER + NUM_TAMANOS_BUFER, leidas.palabras_bufer) > 0;
+	}
+	if (valida && valores.find(clave + ".flujos") != valores.end()) {
+		valida = leer_numero(valores[clave + ".flujos"], leidas.flujos_ilp) &&
+			std::count(FLUJOS_ILP, FLUJOS_ILP + NUM_FLUJOS_ILP, leidas.flujos_ilp) > 0;
+	}
+	if (!valida) {
+		printf("Aviso: Se ignora la configuracion de %s para esta maquina (valores no validos)\n", nombre_archivo);
+		return false;
+	}
+	o = leidas;
+	return true;
+}
+
+// Función para formatear números con coma decimal (formato español)
+static std::string formatearDecimal(double valor, int precision) {
+	char buffer[64];
+	// Formatear con precisión específica
+	snprintf(buffer, sizeof(buffer), "%.*f", precision, valor);
+	std::string resultado = buffer;
+	// Convertir punto a coma para Excel español
+	for (char& c : resultado) {
+		if (c == '.') c = ',';
+	}
+	return resultado;
+}
+
+// Escribe una fila del CSV para un resultado (secuencial u OpenMP)
+static void escribir_fila_csv(std::ofstream& archivo, const ResultadoMontecarlo& r) {
+	archivo << r.samples << ";" << r.metodo << ";" << r.num_hilos << ";"
+		<< formatearDecimal(r.pi, 12) << ";"
+		<< formatearDecimal(r.error_absoluto, 15) << ";"
+		<< formatearDecimal(r.error_relativo, 15) << ";"
+		<< (r.z == r.z ? formatearDecimal(r.z, 4) : std::string()) << ";"
+		<< formatearDecimal(r.tiempo_segundos, 12) << ";"
+		<< formatearDecimal(r.tiempo_ms, 8) << ";"
+		<< formatearDecimal(r.tiempo_us, 8) << ";"
+		<< (r.ic_bootstrap_inferior == r.ic_bootstrap_inferior ? formatearDecimal(r.ic_bootstrap_inferior, 12) : std::string()) << ";"
+		<< (r.ic_bootstrap_superior == r.ic_bootstrap_superior ? formatearDecimal(r.ic_bootstrap_superior, 12) : std::string()) << ";"
+		<< (r.ic_lotes_inferior == r.ic_lotes_inferior ? formatearDecimal(r.ic_lotes_inferior, 12) : std::string()) << ";"
+		<< (r.ic_lotes_superior == r.ic_lotes_superior ? formatearDecimal(r.ic_lotes_superior, 12) : std::string()) << "\n";
+}
+
+/**
+ * Abre el archivo CSV, escribiendo los encabezados si se crea de nuevo
+ *
+ * @return true si el archivo quedó abierto
+ */
+static bool abrir_csv(std::ofstream& archivo, const char* nombre_archivo, bool primera_escritura) {
+	if (primera_escritura) {
 		archivo.open(nombre_archivo);              // Modo sobrescritura
 	}
 	else {
@@ -224,46 +2423,422 @@ void guardar_csv(const ResultadoMontecarlo& secuencial, const ResultadoMontecarl
 	// Verificar que el archivo se abrió correctamente
 	if (!archivo.is_open()) {
 		printf("Error: No se pudo abrir el archivo %s para escritura\n", nombre_archivo);
-		return;
+		return false;
 	}
 
-	// Función lambda para formatear números con coma decimal (formato español)
-	auto formatearDecimal = [](double valor, int precision) -> std::string {
-		char buffer[64];
-		// Formatear con precisión específica
-		snprintf(buffer, sizeof(buffer), "%.*f", precision, valor);
-		std::string resultado = buffer;
-		// Convertir punto a coma para Excel español
-		for (char& c : resultado) {
-			if (c == '.') c = ',';
-		}
-		return resultado;
-		};
-
 	// Escribir encabezados solo en la primera escritura
 	if (primera_escritura) {
 		// Usar punto y coma como separador de campos (CSV español)
-		archivo << "Samples;Método;Hilos;Valor Pi;Tiempo (s);Tiempo (ms);Tiempo (us)\n";
+		archivo << "Samples;Método;Hilos;Valor Pi;Error absoluto;Error relativo;Z;Tiempo (s);Tiempo (ms);Tiempo (us);"
+			"IC bootstrap inferior;IC bootstrap superior;IC lotes inferior;IC lotes superior\n";
 	}
+	return true;
+}
 
-	// Escribir resultados del método secuencial
-	archivo << secuencial.samples << ";Secuencial;" << secuencial.num_hilos << ";"
-		<< formatearDecimal(secuencial.pi, 12) << ";"
-		<< formatearDecimal(secuencial.tiempo_segundos, 12) << ";"
-		<< formatearDecimal(secuencial.tiempo_ms, 8) << ";"
-		<< formatearDecimal(secuencial.tiempo_us, 8) << "\n";
+/**
+ * Función para guardar los resultados en un archivo CSV con formato español
+ *
+ * @param secuencial: Resultados del método secuencial
+ * @param paralelo: Resultados del método paralelo
+ * @param nombre_archivo: Ruta del archivo CSV a crear/modificar
+ * @param primera_escritura: Si es true, crea nuevo archivo; si es false, añade al existente
+ */
+void guardar_csv(const ResultadoMontecarlo& secuencial, const ResultadoMontecarlo& paralelo,
+	const char* nombre_archivo, bool primera_escritura = true) {
+	std::ofstream archivo;
+	if (!abrir_csv(archivo, nombre_archivo, primera_escritura)) {
+		return;
+	}
 
-	// Escribir resultados del método paralelo
-	archivo << paralelo.samples << ";OpenMP;" << paralelo.num_hilos << ";"
-		<< formatearDecimal(paralelo.pi, 12) << ";"
-		<< formatearDecimal(paralelo.tiempo_segundos, 12) << ";"
-		<< formatearDecimal(paralelo.tiempo_ms, 8) << ";"
-		<< formatearDecimal(paralelo.tiempo_us, 8) << "\n";
+	// Escribir resultados de ambos métodos
+	escribir_fila_csv(archivo, secuencial);
+	escribir_fila_csv(archivo, paralelo);
 
 	// Cerrar el archivo
 	archivo.close();
 }
 
+/**
+ * Añade un único resultado al CSV (modos que solo ejecutan una versión).
+ * Si el archivo todavía no existe se crea con sus encabezados.
+ */
+void guardar_csv(const ResultadoMontecarlo& resultado, const char* nombre_archivo) {
+	std::ofstream archivo;
+	if (!abrir_csv(archivo, nombre_archivo, !std::filesystem::exists(nombre_archivo))) {
+		return;
+	}
+	escribir_fila_csv(archivo, resultado);
+	archivo.close();
+}
+
+// Guarda los estadísticos de las réplicas (una fila por tamaño de muestra)
+static void guardar_replicas(const std::vector<ResultadoReplicas>& resultados, const char* nombre_archivo) {
+	std::ofstream archivo(nombre_archivo);
+	if (!archivo.is_open()) {
+		printf("Error: No se pudo abrir el archivo %s para escritura\n", nombre_archivo);
+		return;
+	}
+	archivo << "Samples;Replicas;Hilos;Media;Desviación;Error estándar teórico;Mínimo;Máximo;Tiempo (s)\n";
+	for (const ResultadoReplicas& r : resultados) {
+		archivo << r.samples << ";" << r.replicas << ";" << r.num_hilos << ";"
+			<< formatearDecimal(r.media, 12) << ";" << formatearDecimal(r.desviacion, 15) << ";"
+			<< formatearDecimal(r.error_teorico, 15) << ";" << formatearDecimal(r.minimo, 12) << ";"
+			<< formatearDecimal(r.maximo, 12) << ";" << formatearDecimal(r.tiempo_segundos, 12) << "\n";
+	}
+	archivo.close();
+	printf("Resultados de las replicas guardados en: %s\n", nombre_archivo);
+}
+
+/**
+ * BENCHMARK DE GENERADORES
+ *
+ * El tiempo de ResultadoMontecarlo mezcla el coste del generador con el de la
+ * comprobación geométrica. Este modo mide cada etapa por separado:
+ *   - Cada generador solo, llenando un búfer de la caché L1 una y otra vez
+ *     (la etapa 1 de la tubería con búfer), en todos los hilos a la vez
+ *   - La etapa 2 (conversión a coordenadas y estimador) leyendo siempre el
+ *     mismo búfer ya lleno, sin llamar a ningún generador
+ * Los resultados se muestran por consola y se guardan en ARCHIVO_BENCHMARK.
+ */
+const char* const ARCHIVO_BENCHMARK = "benchmark_generadores.csv";
+const int PALABRAS_BENCHMARK = 1024;  // Búfer por hilo: 8 KB con palabras de 64 bits
+
+// Destino de las comprobaciones: al escribirlas aquí el compilador no puede descartar el trabajo medido
+static volatile double sumidero_benchmark;
+
+struct MedicionBenchmark {
+	std::string nombre;
+	double bits_por_salida;   // Bits aleatorios de cada llamada al generador
+	long long salidas;        // Llamadas (o puntos, en la etapa 2) por hilo
+	double segundos;
+	int hilos = 0;            // Hilos que generan a la vez (0: los del benchmark)
+};
+
+// Genera 'salidas' palabras por hilo con el generador Motor
+template <class Motor>
+static double medir_generador(long long salidas, int hilos) {
+	unsigned long long comprobacion = 0;
+	double inicio = omp_get_wtime();
+#pragma omp parallel num_threads(hilos) reduction(^:comprobacion)
+	{
+		Motor gen;
+		sembrar_bloque(gen, 12345, omp_get_thread_num());
+		typename PalabraMotor<Motor>::tipo bufer[PALABRAS_BENCHMARK];
+		for (long long hecho = 0; hecho < salidas; hecho += PALABRAS_BENCHMARK) {
+			rellenar_palabras(gen, bufer, PALABRAS_BENCHMARK);
+			// Todo el búfer entra en la comprobación: ninguna palabra generada es descartable
+			for (int k = 0; k < PALABRAS_BENCHMARK; k++) comprobacion ^= bufer[k];
+		}
+	}
+	double total = omp_get_wtime() - inicio;
+	sumidero_benchmark = (double)comprobacion;
+	return total;
+}
+
+// rand() no admite siembra por bloques ni búfer propio: se llama directamente.
+// Se mide con un solo hilo porque su estado es global: glibc lo protege con un
+// cerrojo (con varios hilos se mediría la contención) y en otras bibliotecas
+// llamarlo desde varios hilos es una carrera de datos
+static double medir_rand(long long salidas) {
+	unsigned long long comprobacion = 0;
+	double inicio = omp_get_wtime();
+	int bufer[PALABRAS_BENCHMARK];
+	for (long long hecho = 0; hecho < salidas; hecho += PALABRAS_BENCHMARK) {
+		for (int k = 0; k < PALABRAS_BENCHMARK; k++) bufer[k] = rand();
+		for (int k = 0; k < PALABRAS_BENCHMARK; k++) comprobacion ^= (unsigned)bufer[k];
+	}
+	double total = omp_get_wtime() - inicio;
+	sumidero_benchmark = (double)comprobacion;
+	return total;
+}
+
+// Etapa 2 sola: convierte y evalúa una y otra vez los puntos del mismo búfer
+template <class Real, class Est, class Punto>
+static double medir_etapa_consumo(long long puntos, int hilos) {
+	double comprobacion = 0;
+	double inicio = omp_get_wtime();
+#pragma omp parallel num_threads(hilos) reduction(+:comprobacion)
+	{
+		uint64_t bufer[PALABRAS_BENCHMARK];
+		Xoshiro256x8 gen;
+		sembrar_bloque(gen, 12345, omp_get_thread_num());
+		rellenar_palabras(gen, bufer, PALABRAS_BENCHMARK);
+		const long long puntos_por_bufer = PALABRAS_BENCHMARK / Punto::palabras;
+		for (long long hecho = 0; hecho < puntos; hecho += puntos_por_bufer) {
+			comprobacion += (double)consumir_bufer<Real, Est, Punto>(bufer, puntos_por_bufer);
+		}
+	}
+	double total = omp_get_wtime() - inicio;
+	sumidero_benchmark = comprobacion;
+	return total;
+}
+
+// Normales: mismas salidas por hilo, con media y varianza como comprobación
+struct MedicionNormales {
+	std::string nombre;
+	long long salidas;
+	double segundos;
+	double media;
+	double varianza;
+	double varianza_peor;     // Varianza de la posición del lote más alejada de 1
+	double curtosis_peor;     // Curtosis de la posición del lote más alejada de 3
+};
+
+// Genera 'salidas' normales por hilo con el método dado, o con
+// std::normal_distribution sobre el mismo generador si metodo < 0. Además de
+// los momentos globales acumula los de cada posición del lote de
+// LOTE_NORMALES, para detectar posiciones con distinta distribución
+template <class Motor>
+static MedicionNormales medir_normales(const char* nombre, int metodo, long long salidas, int hilos) {
+	std::vector<double> momentos(4 * LOTE_NORMALES, 0.0);  // Σx, Σx², Σx³ y Σx⁴ por posición
+	double inicio = omp_get_wtime();
+#pragma omp parallel num_threads(hilos)
+	{
+		Motor gen;
+		sembrar_bloque(gen, 12345, omp_get_thread_num());
+		std::normal_distribution<double> distribucion;
+		double normales[LOTE_NORMALES];
+		double locales[4 * LOTE_NORMALES] = {};
+		for (long long hecho = 0; hecho < salidas; hecho += LOTE_NORMALES) {
+			if (metodo < 0) {
+				for (int k = 0; k < LOTE_NORMALES; k++) normales[k] = distribucion(gen);
+			}
+			else {
+				generar_normales(metodo, gen, normales, LOTE_NORMALES);
+			}
+			for (int k = 0; k < LOTE_NORMALES; k++) {
+				double cuadrado = normales[k] * normales[k];
+				locales[4 * k] += normales[k];
+				locales[4 * k + 1] += cuadrado;
+				locales[4 * k + 2] += cuadrado * normales[k];
+				locales[4 * k + 3] += cuadrado * cuadrado;
+			}
+		}
+#pragma omp critical
+		for (int k = 0; k < 4 * LOTE_NORMALES; k++) momentos[k] += locales[k];
+	}
+	double total = omp_get_wtime() - inicio;
+
+	double suma = 0, suma_cuadrados = 0;
+	double varianza_peor = 1.0, curtosis_peor = 3.0;
+	double n_posicion = (double)((salidas + LOTE_NORMALES - 1) / LOTE_NORMALES) * hilos;
+	for (int k = 0; k < LOTE_NORMALES; k++) {
+		const double* m = &momentos[4 * k];
+		suma += m[0];
+		suma_cuadrados += m[1];
+		double media = m[0] / n_posicion;
+		double varianza = m[1] / n_posicion - media * media;
+		double cuarto = m[3] / n_posicion - 4 * media * m[2] / n_posicion
+			+ 6 * media * media * m[1] / n_posicion - 3 * media * media * media * media;
+		double curtosis = cuarto / (varianza * varianza);
+		if (fabs(varianza - 1.0) > fabs(varianza_peor - 1.0)) varianza_peor = varianza;
+		if (fabs(curtosis - 3.0) > fabs(curtosis_peor - 3.0)) curtosis_peor = curtosis;
+	}
+	double n = n_posicion * LOTE_NORMALES;
+	double media = suma / n;
+	return { nombre, salidas, total, media, suma_cuadrados / n - media * media, varianza_peor, curtosis_peor };
+}
+
+/**
+ * Ejecuta el benchmark y guarda sus resultados
+ *
+ * @param salidas: Llamadas al generador (y puntos de la etapa 2) por hilo
+ * @param hilos: Hilos que generan a la vez
+ */
+void benchmark_generadores(long long salidas, int hilos) {
+	salidas = (salidas + PALABRAS_BENCHMARK - 1) / PALABRAS_BENCHMARK * PALABRAS_BENCHMARK;
+	int bits_rand = 0;
+	for (long long v = RAND_MAX; v > 0; v >>= 1) bits_rand++;
+
+	std::vector<MedicionBenchmark> generadores;
+	generadores.push_back({ "rand (1 hilo)", (double)bits_rand, salidas, medir_rand(salidas), 1 });
+	generadores.push_back({ "mt19937", 32, salidas, medir_generador<std::mt19937>(salidas, hilos) });
+	generadores.push_back({ "mt19937_64", 64, salidas, medir_generador<std::mt19937_64>(salidas, hilos) });
+	generadores.push_back({ "xoshiro256+x4", 64, salidas, medir_generador<Xoshiro256x4>(salidas, hilos) });
+	generadores.push_back({ "xoshiro256+x8", 64, salidas, medir_generador<Xoshiro256x8>(salidas, hilos) });
+	generadores.push_back({ "xoshiro256+x16", 64, salidas, medir_generador<Xoshiro256x16>(salidas, hilos) });
+	generadores.push_back({ "pcg32", 32, salidas, medir_generador<Pcg32>(salidas, hilos) });
+	generadores.push_back({ "philox4x32", 32, salidas, medir_generador<Philox4x32>(salidas, hilos) });
+	generadores.push_back({ aes_ni_disponible() ? "aes-ctr (AES-NI)" : "aes-ctr (software)", 64, salidas,
+		medir_generador<AesCtr>(salidas, hilos) });
+#if defined(GENERADORES_AES_X86)
+	if (rdrand_disponible()) {
+		generadores.push_back({ "rdrand", 64, salidas, medir_generador<RdRand>(salidas, hilos) });
+	}
+#endif
+
+	// Etapa 2 con las conversiones de la tubería y el estimador de acierto-fallo
+	std::vector<MedicionBenchmark> consumos;
+	consumos.push_back({ "bufer double", 53, salidas,
+		medir_etapa_consumo<double, EstimadorAciertos, PuntoCompleto<uint64_t, double> >(salidas, hilos) });
+	consumos.push_back({ "bufer float", 24, salidas,
+		medir_etapa_consumo<float, EstimadorAciertos, PuntoCompleto<uint64_t, float> >(salidas, hilos) });
+	consumos.push_back({ "dividido-64 double", 32, salidas,
+		medir_etapa_consumo<double, EstimadorAciertos, PuntoDividido<double> >(salidas, hilos) });
+	consumos.push_back({ "bufer double, tabla", 53, salidas,
+		medir_etapa_consumo<double, EstimadorAciertosTabla, PuntoCompleto<uint64_t, double> >(salidas, hilos) });
+	consumos.push_back({ "bufer float, tabla", 24, salidas,
+		medir_etapa_consumo<float, EstimadorAciertosTabla, PuntoCompleto<uint64_t, float> >(salidas, hilos) });
+
+	// Normales: std::normal_distribution frente a los lotes de normales.h
+	std::vector<MedicionNormales> normales;
+	normales.push_back(medir_normales<std::mt19937_64>("std mt19937_64", -1, salidas, hilos));
+	normales.push_back(medir_normales<std::mt19937_64>("box-muller mt19937_64", NORMAL_BOX_MULLER, salidas, hilos));
+	normales.push_back(medir_normales<std::mt19937_64>("ziggurat mt19937_64", NORMAL_ZIGGURAT, salidas, hilos));
+	normales.push_back(medir_normales<Xoshiro256x8>("std xoshiro256+x8", -1, salidas, hilos));
+	normales.push_back(medir_normales<Xoshiro256x8>("box-muller xoshiro256+x8", NORMAL_BOX_MULLER, salidas, hilos));
+	normales.push_back(medir_normales<Xoshiro256x8>("ziggurat xoshiro256+x8", NORMAL_ZIGGURAT, salidas, hilos));
+
+	printf("----------------Benchmark de generadores (%d hilos)----------------\n", hilos);
+	printf("%-20s %14s %18s\n", "Generador", "MB/s (total)", "ns/palabra de 64b");
+	for (const MedicionBenchmark& m : generadores) {
+		double bytes = m.salidas * m.bits_por_salida / 8.0 * (m.hilos > 0 ? m.hilos : hilos);
+		double palabras_64 = m.salidas * m.bits_por_salida / 64.0;
+		printf("%-20s %14.1f %18.3f\n", m.nombre.c_str(), bytes / m.segundos / 1e6,
+			m.segundos * 1e9 / palabras_64);
+	}
+	printf("\n%-20s %14s %18s\n", "Etapa 2 (aciertos)", "Mpuntos/s", "ns/punto");
+	for (const MedicionBenchmark& m : consumos) {
+		printf("%-20s %14.1f %18.3f\n", m.nombre.c_str(), m.salidas * (double)hilos / m.segundos / 1e6,
+			m.segundos * 1e9 / m.salidas);
+	}
+	printf("\n%-26s %12s %10s %10s %10s %10s %10s\n", "Normales", "Mnormales/s", "ns/normal", "media", "varianza",
+		"peor var.", "peor curt.");
+	for (const MedicionNormales& m : normales) {
+		printf("%-26s %12.1f %10.3f %10.5f %10.5f %10.4f %10.4f\n", m.nombre.c_str(),
+			m.salidas * (double)hilos / m.segundos / 1e6, m.segundos * 1e9 / m.salidas, m.media, m.varianza,
+			m.varianza_peor, m.curtosis_peor);
+	}
+	printf("(peor var./curt.: la posicion del lote de %d normales mas alejada de 1 y de 3)\n", LOTE_NORMALES);
+	printf("(ns por hilo: tiempo de pared dividido por el trabajo de un hilo)\n");
+	printf("-------------------------------------------------------------------\n\n");
+
+	std::ofstream archivo(ARCHIVO_BENCHMARK);
+	if (!archivo.is_open()) {
+		printf("Error: No se pudo abrir el archivo %s para escritura\n", ARCHIVO_BENCHMARK);
+		return;
+	}
+	archivo << "Etapa;Nombre;Hilos;Bits por salida;Salidas por hilo;Tiempo (s);MB/s;ns por palabra de 64 bits\n";
+	for (const MedicionBenchmark& m : generadores) {
+		int hilos_medicion = m.hilos > 0 ? m.hilos : hilos;
+		double bytes = m.salidas * m.bits_por_salida / 8.0 * hilos_medicion;
+		archivo << "Generador;" << m.nombre << ";" << hilos_medicion << ";" << formatearDecimal(m.bits_por_salida, 0) << ";"
+			<< m.salidas << ";" << formatearDecimal(m.segundos, 6) << ";"
+			<< formatearDecimal(bytes / m.segundos / 1e6, 1) << ";"
+			<< formatearDecimal(m.segundos * 1e9 / (m.salidas * m.bits_por_salida / 64.0), 3) << "\n";
+	}
+	for (const MedicionBenchmark& m : consumos) {
+		archivo << "Consumo;" << m.nombre << ";" << hilos << ";" << formatearDecimal(m.bits_por_salida, 0) << ";"
+			<< m.salidas << ";" << formatearDecimal(m.segundos, 6) << ";;"
+			<< formatearDecimal(m.segundos * 1e9 / m.salidas, 3) << "\n";
+	}
+	for (const MedicionNormales& m : normales) {
+		archivo << "Normales;" << m.nombre << ";" << hilos << ";;"
+			<< m.salidas << ";" << formatearDecimal(m.segundos, 6) << ";;"
+			<< formatearDecimal(m.segundos * 1e9 / m.salidas, 3) << "\n";
+	}
+	archivo.close();
+	printf("Resultados del benchmark guardados en: %s\n", ARCHIVO_BENCHMARK);
+}
+
+// Control de la ejecución desde la línea de comandos: Ctrl+C cancela de forma
+// cooperativa (se guarda el checkpoint y el resultado parcial) en lugar de
+// matar el proceso
+static ControlEjecucion control_cli;
+
+static void manejador_interrupcion(int) {
+	control_cli.cancelado.store(true);
+}
+
+static void mostrar_progreso(long long bloques_hechos, long long bloques_totales, void*) {
+	printf("Progreso: %lld / %lld bloques (%.1f%%)\n", bloques_hechos, bloques_totales,
+		100.0 * bloques_hechos / bloques_totales);
+	fflush(stdout);
+}
+
+/**
+ * MODOS DE LA LÍNEA DE COMANDOS
+ *
+ * Cada modo tiene su propio bucle y termina al acabar, así que son excluyentes,
+ * y cada uno solo usa algunas de las opciones de ajuste. En lugar de ignorar en
+ * silencio las que no usa, se rechaza la combinación. --hilos vale para todos.
+ */
+enum ModoPrograma {
+	MODO_PRUEBAS, MODO_LARGO, MODO_EXTENDER, MODO_AUTO, MODO_PRESUPUESTO, MODO_AUTOTUNE,
+	MODO_BENCHMARK, MODO_RETICULA, MODO_PI_DIGITOS, MODO_INTEGRADOR, MODO_INTEGRANDO,
+	MODO_REPLICAS, MODO_CONJUNTO, MODO_OPCION, MODO_BUFFON, MODO_BOLA, NUM_MODOS
+};
+
+// Opciones que solo tienen efecto en algunos modos (un bit por opción)
+enum OpcionDeModo {
+	OPC_SAMPLES = 1 << 0, OPC_SEMILLA = 1 << 1, OPC_CHECKPOINT = 1 << 2, OPC_INTERVALO = 1 << 3,
+	OPC_RESUME = 1 << 4, OPC_REGISTRO = 1 << 5, OPC_REPETICIONES = 1 << 6, OPC_RECALIBRAR = 1 << 7,
+	OPC_ESTIMADOR = 1 << 8, OPC_VARIANTE = 1 << 9, OPC_BUFER = 1 << 10, OPC_FLUJOS = 1 << 11,
+	OPC_GENERADOR = 1 << 12, OPC_INTERVALOS = 1 << 13, OPC_PASOS = 1 << 14, OPC_NORMAL = 1 << 15,
+	OPC_PROGRESO = 1 << 16
+};
+const char* const NOMBRES_OPCION_DE_MODO[] = {
+	"<samples>", "--semilla", "--checkpoint", "--intervalo", "--resume", "--registro", "--repeticiones",
+	"--recalibrar", "--estimador", "--variante", "--bufer", "--flujos", "--generador", "--intervalos",
+	"--pasos", "--normal", "--progreso"
+};
+const int NUM_OPCIONES_DE_MODO = sizeof(NOMBRES_OPCION_DE_MODO) / sizeof(NOMBRES_OPCION_DE_MODO[0]);
+
+// Elección del núcleo de π de la versión paralela
+const unsigned OPC_NUCLEO = OPC_ESTIMADOR | OPC_VARIANTE | OPC_BUFER | OPC_FLUJOS | OPC_GENERADOR;
+
+struct DescripcionModo {
+	const char* nombre;   // Opción que elige el modo, para los mensajes
+	unsigned admitidas;   // Opciones de OpcionDeModo que usa
+};
+
+const DescripcionModo MODOS[NUM_MODOS] = {
+	{ "las pruebas por defecto", OPC_SAMPLES | OPC_SEMILLA | OPC_NUCLEO | OPC_INTERVALOS | OPC_PROGRESO },
+	{ "--checkpoint/--resume/--registro", OPC_SAMPLES | OPC_SEMILLA | OPC_NUCLEO | OPC_INTERVALOS |
+		OPC_PROGRESO | OPC_CHECKPOINT | OPC_INTERVALO | OPC_RESUME | OPC_REGISTRO },
+	{ "--extender", OPC_REGISTRO | OPC_BUFER | OPC_FLUJOS | OPC_PROGRESO },  // El núcleo y la semilla son los del registro
+	{ "--modo auto", OPC_SAMPLES | OPC_SEMILLA | OPC_NUCLEO | OPC_INTERVALOS | OPC_PROGRESO | OPC_RECALIBRAR },
+	{ "--presupuesto-ms", OPC_SEMILLA | OPC_NUCLEO | OPC_REPETICIONES },
+	{ "--autotune", OPC_SAMPLES | OPC_NUCLEO },  // El núcleo pedido es el punto de partida
+	{ "--benchmark-generadores", OPC_SAMPLES },
+	{ "--reticula", 0 },
+	{ "--pi-digitos", 0 },
+	{ "--integrador", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR },
+	{ "--integrando", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR },
+	{ "--replicas", OPC_SAMPLES | OPC_SEMILLA | OPC_NUCLEO },
+	{ "--conjunto", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR },
+	{ "--opcion", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR | OPC_PASOS | OPC_NORMAL },
+	{ "--buffon", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR | OPC_PROGRESO },
+	{ "--dimension", OPC_SAMPLES | OPC_SEMILLA | OPC_GENERADOR | OPC_PROGRESO },
+};
+
+// Anota el modo pedido en la línea de comandos; false si ya se había pedido otro
+static bool elegir_modo(int& modo, int pedido) {
+	if (modo != MODO_PRUEBAS && modo != pedido) {
+		printf("Error: %s no se puede combinar con %s\n", MODOS[modo].nombre, MODOS[pedido].nombre);
+		return false;
+	}
+	modo = pedido;
+	return true;
+}
+
+/**
+ * Comprueba que todas las opciones usadas tienen efecto en el modo elegido
+ *
+ * @param usadas: Opciones de OpcionDeModo que aparecen en la línea de comandos
+ * @return false (con el mensaje de error) si alguna se ignoraría
+ */
+static bool comprobar_opciones_modo(int modo, unsigned usadas) {
+	unsigned sobran = usadas & ~MODOS[modo].admitidas;
+	for (int k = 0; k < NUM_OPCIONES_DE_MODO; k++) {
+		if (sobran & (1u << k)) {
+			printf("Error: %s no tiene efecto con %s\n", NOMBRES_OPCION_DE_MODO[k], MODOS[modo].nombre);
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * Función principal del programa
  *
@@ -287,15 +2862,520 @@ int main(int argc, char* argv[]) {
 
 	int num_pruebas = sizeof(tamanos_muestra) / sizeof(tamanos_muestra[0]);
 
-	// Procesar argumentos de línea de comandos si existen
-	if (argc > 1) {
-		// Si el usuario proporciona un tamaño, usar solo ese
-		tamanos_muestra[0] = atoll(argv[1]);
-		num_pruebas = 1;
+	// Procesar argumentos de línea de comandos si existen:
+	//   <samples>             Usar solo ese tamaño de muestra
+	//   --semilla N           Semilla fija para la versión paralela
+	//   --checkpoint ARCHIVO  Guardar periódicamente el progreso de la versión paralela
+	//   --intervalo S         Segundos entre checkpoints (60 por defecto)
+	//   --resume              Continuar la ejecución guardada en el checkpoint
+	//   --registro ARCHIVO    Guardar semilla, samples y suma de la versión paralela
+	//   --extender M          Ampliar el registro existente hasta M muestras
+	//   --presupuesto-ms T    Tantas muestras como quepan en T milisegundos
+	//   --repeticiones R      Repetir el modo con presupuesto R veces (percentiles de retraso)
+	//   --progreso N          Mostrar el progreso de la versión paralela cada N bloques
+	//   --modo auto           Elegir secuencial / pocos hilos / todos según la calibración
+	//   --recalibrar          Repetir la calibración del modo auto aunque haya una guardada
+	//   --hilos N             Número de hilos de la versión paralela
+	//   --estimador E         Estimador de la versión paralela: aciertos | valor-medio |
+	//                         aciertos-tabla (mismos aciertos, resueltos con la rejilla)
+	//   --variante V          Bucle de la versión paralela: escalar | bufer | dividido-64 | ilp
+	//                         (dividido-64 necesita un generador de 64 bits: con
+	//                         mt19937 se cambia a mt19937_64; 32 bits por coordenada)
+	//   --bufer N             Palabras del búfer de bufer y dividido-64 (256, 1024 o 4096)
+	//   --flujos K            Generadores intercalados de la variante ilp (2, 4 u 8)
+	//   --generador G         Generador de la versión paralela: mt19937 | mt19937_64 |
+	//                         xoshiro256+x4 | xoshiro256+x8 | xoshiro256+x16 | aes-ctr
+	//   --autotune            Buscar y guardar la mejor configuración para esta máquina
+	//                         (con <samples> como tamaño del benchmark)
+	//   --reticula R          Estimar π contando los centros de una retícula de R x R celdas
+	//   --pi-digitos D        Calcular π con D cifras (Chudnovsky) como carga de CPU
+	//   --integrador          Estimar π con el integrador genérico (integrador_montecarlo.h)
+	//   --integrando EXPR     Integrar EXPR sobre [0,1]^D (variables x, y, z, w o x0..x7),
+	//                         p. ej. "4*sqrt(1-x*x)" o "4*(x^2+y^2<=1)"
+	//   --intervalos          Intervalos de confianza bootstrap y por lotes en la versión paralela
+	//   --replicas R          R estimaciones independientes por tamaño de muestra, con
+	//                         media, desviación típica, mínimo y máximo
+	//   --conjunto            Acierto-fallo, valor medio y antitético sobre los mismos puntos
+	//                         (una fila del CSV por estimador y comparación de varianzas)
+	//   --opcion O            Valorar una call por Monte Carlo: europea | asiatica (geométrica),
+	//                         con S = K = 100, r = 5 %, sigma = 20 %, T = 1 año
+	//   --pasos N             Observaciones de la opción asiática (12 por defecto)
+	//   --normal M            Normales de la valoración: box-muller | ziggurat
+	//   --buffon E            Estimar π con la aguja de Buffon: aguja | laplace (cuadrícula)
+	//   --dimension D         Estimar el volumen de la bola unidad en D dimensiones (2 a 32)
+	//                         con el motor paralelo, y π a partir de él
+	//   --benchmark-generadores  Medir solo los generadores, solo la etapa de consumo y las normales
+	//                         (con <samples> como palabras por hilo)
+	// Los modos son excluyentes y cada uno rechaza las opciones que no usa (ver MODOS)
+	OpcionesParalelo opciones;
+	if (cargar_autotune(ARCHIVO_AUTOTUNE, opciones)) {
+		printf("Usando la configuracion del autotuner para %s\n", clave_maquina().c_str());
+	}
+	bool reanudar = false;
+	bool hacer_autotune = false;
+	bool hacer_benchmark = false;
+	long long radio_reticula = 0;
+	long long cifras_pi_pedidas = 0;
+	bool usar_integrador = false;
+	const char* integrando = nullptr;
+	ContratoOpcion contrato;
+	bool valorar = false;
+	bool pasada_conjunta = false;
+	int replicas = 0;
+	const char* archivo_registro = nullptr;
+	long long extender_hasta = 0;
+	double presupuesto_ms = 0.0;
+	int repeticiones = 1;
+	bool modo_auto = false;
+	bool recalibrar = false;
+	int modo = MODO_PRUEBAS;
+	unsigned usadas = 0;  // Opciones de OpcionDeModo que aparecen
+	for (int arg = 1; arg < argc; arg++) {
+		std::string opcion = argv[arg];
+		bool tiene_valor = arg + 1 < argc;
+		if (opcion == "--semilla" && tiene_valor) {
+			usadas |= OPC_SEMILLA;
+			opciones.semilla_fija = true;
+			if (!leer_numero(argv[++arg], opciones.semilla)) {
+				printf("Error: Semilla no valida: %s (entero sin signo de 64 bits)\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--checkpoint" && tiene_valor) {
+			usadas |= OPC_CHECKPOINT;
+			opciones.archivo_checkpoint = argv[++arg];
+		}
+		else if (opcion == "--intervalo" && tiene_valor) {
+			usadas |= OPC_INTERVALO;
+			opciones.intervalo_checkpoint_s = atof(argv[++arg]);
+		}
+		else if (opcion == "--resume") {
+			usadas |= OPC_RESUME;
+			reanudar = true;
+		}
+		else if (opcion == "--registro" && tiene_valor) {
+			usadas |= OPC_REGISTRO;
+			archivo_registro = argv[++arg];
+		}
+		else if (opcion == "--extender" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_EXTENDER)) return 1;
+			extender_hasta = atoll(argv[++arg]);
+		}
+		else if (opcion == "--presupuesto-ms" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_PRESUPUESTO)) return 1;
+			presupuesto_ms = atof(argv[++arg]);
+		}
+		else if (opcion == "--repeticiones" && tiene_valor) {
+			usadas |= OPC_REPETICIONES;
+			repeticiones = atoi(argv[++arg]);
+		}
+		else if (opcion == "--modo" && tiene_valor && std::string(argv[arg + 1]) == "auto") {
+			if (!elegir_modo(modo, MODO_AUTO)) return 1;
+			modo_auto = true;
+			++arg;
+		}
+		else if (opcion == "--recalibrar") {
+			usadas |= OPC_RECALIBRAR;
+			recalibrar = true;
+		}
+		else if (opcion == "--hilos" && tiene_valor) {
+			if (!leer_numero(argv[++arg], opciones.num_hilos) || opciones.num_hilos < 1) {
+				printf("Error: Numero de hilos no valido: %s (debe ser al menos 1)\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--estimador" && tiene_valor) {
+			usadas |= OPC_ESTIMADOR;
+			opciones.estimador = buscar_nombre(NOMBRES_ESTIMADOR, NUM_ESTIMADORES, argv[++arg]);
+			if (opciones.estimador < 0) {
+				printf("Error: Estimador desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--variante" && tiene_valor) {
+			usadas |= OPC_VARIANTE;
+			opciones.variante = buscar_nombre(NOMBRES_VARIANTE, NUM_VARIANTES, argv[++arg]);
+			if (opciones.variante < 0) {
+				printf("Error: Variante desconocida: %s\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--bufer" && tiene_valor) {
+			usadas |= OPC_BUFER;
+			if (!leer_numero(argv[++arg], opciones.palabras_bufer) ||
+				std::count(TAMANOS_BUFER, TAMANOS_BUFER + NUM_TAMANOS_BUFER, opciones.palabras_bufer) == 0) {
+				printf("Error: Tamano de bufer no valido: %s (validos: %s)\n", argv[arg],
+					listar_valores(TAMANOS_BUFER, NUM_TAMANOS_BUFER).c_str());
+				return 1;
+			}
+		}
+		else if (opcion == "--flujos" && tiene_valor) {
+			usadas |= OPC_FLUJOS;
+			if (!leer_numero(argv[++arg], opciones.flujos_ilp) ||
+				std::count(FLUJOS_ILP, FLUJOS_ILP + NUM_FLUJOS_ILP, opciones.flujos_ilp) == 0) {
+				printf("Error: Numero de flujos no valido: %s (validos: %s)\n", argv[arg],
+					listar_valores(FLUJOS_ILP, NUM_FLUJOS_ILP).c_str());
+				return 1;
+			}
+		}
+		else if (opcion == "--generador" && tiene_valor) {
+			usadas |= OPC_GENERADOR;
+			opciones.generador = buscar_nombre(NOMBRES_GENERADOR, NUM_GENERADORES, argv[++arg]);
+			if (opciones.generador < 0) {
+				printf("Error: Generador desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--autotune") {
+			if (!elegir_modo(modo, MODO_AUTOTUNE)) return 1;
+			hacer_autotune = true;
+		}
+		else if (opcion == "--reticula" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_RETICULA)) return 1;
+			radio_reticula = atoll(argv[++arg]);
+		}
+		else if (opcion == "--integrando" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_INTEGRANDO)) return 1;
+			integrando = argv[++arg];
+		}
+		else if (opcion == "--integrador") {
+			if (!elegir_modo(modo, MODO_INTEGRADOR)) return 1;
+			usar_integrador = true;
+		}
+		else if (opcion == "--intervalos") {
+			usadas |= OPC_INTERVALOS;
+			opciones.intervalos = true;
+		}
+		else if (opcion == "--replicas" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_REPLICAS)) return 1;
+			replicas = atoi(argv[++arg]);
+			if (replicas < 2) {
+				printf("Error: Hacen falta al menos 2 replicas\n");
+				return 1;
+			}
+		}
+		else if (opcion == "--conjunto") {
+			if (!elegir_modo(modo, MODO_CONJUNTO)) return 1;
+			pasada_conjunta = true;
+		}
+		else if (opcion == "--opcion" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_OPCION)) return 1;
+			contrato.tipo = buscar_nombre(NOMBRES_OPCION, NUM_TIPOS_OPCION, argv[++arg]);
+			if (contrato.tipo < 0) {
+				printf("Error: Tipo de opcion desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+			valorar = true;
+		}
+		else if (opcion == "--normal" && tiene_valor) {
+			usadas |= OPC_NORMAL;
+			opciones.metodo_normal = buscar_nombre(NOMBRES_NORMAL, NUM_METODOS_NORMAL, argv[++arg]);
+			if (opciones.metodo_normal < 0) {
+				printf("Error: Metodo de normales desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--pasos" && tiene_valor) {
+			usadas |= OPC_PASOS;
+			contrato.pasos = atoi(argv[++arg]);
+			if (contrato.pasos < 1) {
+				printf("Error: El numero de pasos debe ser positivo\n");
+				return 1;
+			}
+		}
+		else if (opcion == "--buffon" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_BUFFON)) return 1;
+			opciones.experimento_buffon = buscar_nombre(NOMBRES_BUFFON, NUM_EXPERIMENTOS_BUFFON, argv[++arg]);
+			if (opciones.experimento_buffon < 0) {
+				printf("Error: Experimento de Buffon desconocido: %s\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion == "--dimension" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_BOLA)) return 1;
+			opciones.dimension_bola = atoi(argv[++arg]);
+			if (opciones.dimension_bola < DIMENSION_MIN_BOLA || opciones.dimension_bola > DIMENSION_MAX_BOLA) {
+				printf("Error: La dimension debe estar entre %d y %d\n", DIMENSION_MIN_BOLA, DIMENSION_MAX_BOLA);
+				return 1;
+			}
+		}
+		else if (opcion == "--pi-digitos" && tiene_valor) {
+			if (!elegir_modo(modo, MODO_PI_DIGITOS)) return 1;
+			cifras_pi_pedidas = atoll(argv[++arg]);
+		}
+		else if (opcion == "--benchmark-generadores") {
+			if (!elegir_modo(modo, MODO_BENCHMARK)) return 1;
+			hacer_benchmark = true;
+		}
+		else if (opcion == "--progreso" && tiene_valor) {
+			usadas |= OPC_PROGRESO;
+			control_cli.progreso = mostrar_progreso;
+			if (!leer_numero(argv[++arg], control_cli.bloques_entre_avisos) || control_cli.bloques_entre_avisos < 1) {
+				printf("Error: Intervalo de progreso no valido: %s (bloques, al menos 1)\n", argv[arg]);
+				return 1;
+			}
+		}
+		else if (opcion.compare(0, 2, "--") == 0) {
+			printf("Error: Opcion desconocida o sin valor: %s\n", opcion.c_str());
+			return 1;
+		}
+		else {
+			// Si el usuario proporciona un tamaño, usar solo ese
+			usadas |= OPC_SAMPLES;
+			tamanos_muestra[0] = atoll(argv[arg]);
+			num_pruebas = 1;
+		}
+	}
+
+	// dividido-64 saca las dos coordenadas de una palabra de 64 bits
+	if (opciones.variante == VAR_DIVIDIDO && opciones.generador == GEN_MT19937) {
+		opciones.generador = GEN_MT19937_64;
+	}
+
+	// Checkpoints y registros sin otro modo: ejecución larga de un solo tamaño.
+	// Después, rechazar las opciones que el modo elegido ignoraría
+	if (modo == MODO_PRUEBAS && (usadas & (OPC_CHECKPOINT | OPC_RESUME | OPC_REGISTRO))) {
+		modo = MODO_LARGO;
+	}
+	if (!comprobar_opciones_modo(modo, usadas)) {
+		return 1;
 	}
 
 	// Nombre del archivo CSV para guardar resultados
 	const char* nombre_archivo = "resultados_montecarlo_openmp.csv";
+
+	opciones.control = &control_cli;
+	signal(SIGINT, manejador_interrupcion);
+
+	// Benchmark de generadores: medir cada etapa por separado y terminar
+	if (hacer_benchmark) {
+		benchmark_generadores(num_pruebas == 1 ? tamanos_muestra[0] : 16777216, opciones.num_hilos);
+		return 0;
+	}
+
+	// Retícula determinista con el radio indicado
+	if (radio_reticula > 0) {
+		if (radio_reticula > 1000000000LL) {
+			printf("Error: El radio de la reticula no puede superar 10^9\n");
+			return 1;
+		}
+		guardar_csv(montecarlo_reticula(radio_reticula, opciones.num_hilos), nombre_archivo);
+		printf("Resultado guardado en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Referencia de π con Chudnovsky: carga de CPU para las pruebas de escalado
+	if (cifras_pi_pedidas > 0) {
+		if (cifras_pi_pedidas > 100000000LL) {
+			printf("Error: No se pueden pedir mas de 10^8 cifras\n");
+			return 1;
+		}
+		guardar_csv(calcular_referencia(cifras_pi_pedidas, opciones.num_hilos), nombre_archivo);
+		printf("Resultado guardado en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Integrando definido como texto, para cada tamaño de muestra
+	if (integrando != nullptr) {
+		for (int i = 0; i < num_pruebas; i++) {
+			if (!integrar_expresion(integrando, tamanos_muestra[i], opciones)) {
+				return 1;
+			}
+		}
+		return 0;
+	}
+
+	// π con el integrador genérico, para cada tamaño de muestra
+	if (usar_integrador) {
+		for (int i = 0; i < num_pruebas; i++) {
+			guardar_csv(montecarlo_integrador(tamanos_muestra[i], opciones), nombre_archivo);
+		}
+		printf("Resultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Réplicas independientes de cada tamaño de muestra
+	if (replicas > 0) {
+		std::vector<ResultadoReplicas> resultados;
+		for (int i = 0; i < num_pruebas; i++) {
+			resultados.push_back(montecarlo_replicas(tamanos_muestra[i], replicas, opciones));
+		}
+		guardar_replicas(resultados, ARCHIVO_REPLICAS);
+		return 0;
+	}
+
+	// Pasada conjunta, con una fila por estimador para cada tamaño de muestra
+	if (pasada_conjunta) {
+		for (int i = 0; i < num_pruebas; i++) {
+			for (const ResultadoMontecarlo& resultado : montecarlo_conjunto(tamanos_muestra[i], opciones)) {
+				guardar_csv(resultado, nombre_archivo);
+			}
+		}
+		printf("Resultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Valoración de opciones, con cada tamaño de muestra como número de caminos
+	if (valorar) {
+		for (int i = 0; i < num_pruebas; i++) {
+			guardar_csv(montecarlo_opcion(tamanos_muestra[i], contrato, opciones), nombre_archivo);
+		}
+		printf("Resultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Aguja de Buffon, para cada tamaño de muestra
+	if (opciones.experimento_buffon >= 0) {
+		for (int i = 0; i < num_pruebas; i++) {
+			ResultadoMontecarlo resultado = montecarlo_buffon(tamanos_muestra[i], opciones);
+			guardar_csv(resultado, nombre_archivo);
+			if (resultado.cancelado) {
+				break;
+			}
+		}
+		printf("Resultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Bola unidad en D dimensiones, para cada tamaño de muestra
+	if (opciones.dimension_bola > 0) {
+		for (int i = 0; i < num_pruebas; i++) {
+			ResultadoMontecarlo resultado = montecarlo_bola(tamanos_muestra[i], opciones);
+			if (resultado.suma > 0) {
+				guardar_csv(resultado, nombre_archivo);  // Sin puntos dentro no hay estimación que guardar
+			}
+			if (resultado.cancelado) {
+				break;
+			}
+		}
+		printf("Resultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Autotune: medir, guardar la configuración ganadora y terminar
+	if (hacer_autotune) {
+		long long samples = num_pruebas == 1 ? tamanos_muestra[0] : 4194304;
+		OpcionesParalelo mejor = autotune(samples, opciones);
+		if (guardar_autotune(ARCHIVO_AUTOTUNE, mejor)) {
+			printf("Configuracion guardada en: %s\n", ARCHIVO_AUTOTUNE);
+		}
+		return 0;
+	}
+
+	// Presupuesto de tiempo: la mejor estimación posible dentro de T ms, con
+	// estadísticas del retraso sobre el límite si se repite varias veces
+	if (presupuesto_ms > 0.0) {
+		if (repeticiones < 1) repeticiones = 1;
+		std::vector<double> excesos_us;
+		long long total_samples = 0;
+		ResultadoMontecarlo resultado;
+
+		for (int r = 0; r < repeticiones; r++) {
+			resultado = montecarlo_presupuesto(presupuesto_ms * 1e-3, opciones);
+			excesos_us.push_back(resultado.tiempo_us - presupuesto_ms * 1e3);
+			total_samples += resultado.samples;
+		}
+		std::sort(excesos_us.begin(), excesos_us.end());
+
+		printf("----------------OpenMP MonterCarlo con Presupuesto de Tiempo----------------\n");
+		printf("Nucleo: %s/%s/%s, %s\n", NOMBRES_ESTIMADOR[opciones.estimador],
+			NOMBRES_GENERADOR[opciones.generador], NOMBRES_PRECISION[opciones.precision],
+			describir_variante(opciones).c_str());
+		printf("Numero de Hilos utilizados: %d\n", resultado.num_hilos);
+		printf("Presupuesto = %.3f ms, Repeticiones = %d\n", presupuesto_ms, repeticiones);
+		printf("Ultima estimacion: pi = %.12f con %lld samples\n", resultado.pi, resultado.samples);
+		imprimir_error(resultado);
+		printf("Samples medios por ejecucion = %.0f\n", (double)total_samples / repeticiones);
+		printf("Retraso sobre el limite (us): p50 = %.2f, p99 = %.2f, max = %.2f\n",
+			percentil(excesos_us, 0.50), percentil(excesos_us, 0.99), excesos_us.back());
+		printf("-------------------------------------------------------------------\n\n");
+		return 0;
+	}
+
+	// Ampliar una estimación previa: solo se calculan las muestras nuevas
+	if (extender_hasta > 0) {
+		RegistroEjecucion registro;
+		if (archivo_registro == nullptr) {
+			printf("Error: --extender necesita --registro ARCHIVO\n");
+			return 1;
+		}
+		if (!cargar_registro(archivo_registro, registro)) {
+			return 1;
+		}
+		if (extender_hasta <= registro.samples) {
+			printf("Error: El registro ya tiene %lld muestras\n", registro.samples);
+			return 1;
+		}
+
+		ResultadoMontecarlo resultado = extender_estimacion(registro, extender_hasta, opciones);
+		registro.samples = resultado.samples;
+		registro.suma = resultado.suma;
+		guardar_registro(archivo_registro, registro);
+		guardar_csv(resultado, nombre_archivo);
+		printf("\nResultado guardado en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Ejecuciones largas con checkpoint o registro: solo versión paralela y un
+	// único tamaño (el indicado, o el guardado en el checkpoint al reanudar)
+	if (reanudar || opciones.archivo_checkpoint != nullptr || archivo_registro != nullptr) {
+		if (reanudar && opciones.archivo_checkpoint == nullptr) {
+			opciones.archivo_checkpoint = "montecarlo_checkpoint.txt";
+		}
+
+		EstadoCheckpoint previo;
+		long long samples = tamanos_muestra[0];
+		if (reanudar) {
+			if (!cargar_checkpoint(opciones.archivo_checkpoint, previo)) {
+				return 1;
+			}
+			samples = previo.samples;
+			opciones.reanudar_desde = &previo;
+		}
+
+		ResultadoMontecarlo resultado = montecarlo_paralelo(samples, opciones);
+		// Una ejecución cancelada no cubre un rango contiguo de muestras y no
+		// sirve como registro ampliable
+		if (archivo_registro != nullptr && !resultado.cancelado) {
+			RegistroEjecucion registro;
+			registro.semilla = resultado.semilla;
+			registro.samples = resultado.samples;
+			registro.muestras_por_bloque = MUESTRAS_POR_BLOQUE;
+			registro.suma = resultado.suma;
+			registro.generador = reanudar ? previo.generador : opciones.generador;
+			registro.precision = reanudar ? previo.precision : opciones.precision;
+			registro.estimador = reanudar ? previo.estimador : opciones.estimador;
+			registro.variante = reanudar ? previo.variante : opciones.variante;
+			guardar_registro(archivo_registro, registro);
+		}
+		guardar_csv(resultado, nombre_archivo);
+		printf("\nResultado guardado en: %s\n", nombre_archivo);
+		return 0;
+	}
+
+	// Modo automático: cada tamaño se ejecuta solo por la ruta más rápida
+	if (modo_auto) {
+		const char* archivo_calibracion = "calibracion_montecarlo.txt";
+		CalibracionAuto calibracion;
+		if (recalibrar || !cargar_calibracion(archivo_calibracion, opciones.num_hilos, calibracion)) {
+			calibracion = calibrar_cruce(opciones);
+			guardar_calibracion(archivo_calibracion, calibracion);
+		}
+		printf("Umbrales: %d hilos desde %lld samples, %d hilos desde %lld samples\n\n",
+			calibracion.hilos_equipo_pequeno, calibracion.umbral_equipo_pequeno,
+			calibracion.hilos_equipo_completo, calibracion.umbral_equipo_completo);
+
+		for (int i = 0; i < num_pruebas; i++) {
+			ResultadoMontecarlo resultado = montecarlo_auto(tamanos_muestra[i], calibracion, opciones);
+			guardar_csv(resultado, nombre_archivo);
+			if (resultado.cancelado) {
+				break;
+			}
+		}
+		printf("\nResultados guardados en: %s\n", nombre_archivo);
+		return 0;
+	}
+
 	printf("\n====== INICIANDO PRUEBAS CON DIFERENTES TAMANYOS DE MUESTRA ======\n\n");
 
 	// Ejecutar pruebas para cada tamaño de muestra
@@ -305,16 +3385,29 @@ int main(int argc, char* argv[]) {
 
 		// Ejecutar ambas versiones
 		ResultadoMontecarlo resultado_secuencial = montecarlo_secuencial(samples);
-		ResultadoMontecarlo resultado_paralelo = montecarlo_paralelo(samples);
+		ResultadoMontecarlo resultado_paralelo = montecarlo_paralelo(samples, opciones);
 
 		// Comparar precisión de los resultados
 		printf("Comparacion de resultados:\n");
 		printf("PI secuencial: %.12f\n", resultado_secuencial.pi);
 		printf("PI paralelo:   %.12f\n", resultado_paralelo.pi);
 		printf("Diferencia:    %.12f\n", fabs(resultado_secuencial.pi - resultado_paralelo.pi));
+		printf("PI referencia: %s\n", cifras_pi(referencia_pi(), 15).c_str());
+		printf("Error secuencial: %.3e (z = %.2f)\n", resultado_secuencial.error_absoluto, resultado_secuencial.z);
+		printf("Error paralelo:   %.3e (z = %.2f)\n", resultado_paralelo.error_absoluto, resultado_paralelo.z);
 
 		// Guardar resultados en CSV (primera iteración crea archivo, las siguientes añaden)
 		guardar_csv(resultado_secuencial, resultado_paralelo, nombre_archivo, i == 0);
+
+		// Referencia determinista con el mismo número de puntos (retícula de R² >= samples celdas)
+		if (!resultado_paralelo.cancelado) {
+			guardar_csv(montecarlo_reticula(radio_equivalente(samples), opciones.num_hilos), nombre_archivo);
+		}
+
+		// Tras Ctrl+C no se empiezan más pruebas
+		if (resultado_paralelo.cancelado) {
+			break;
+		}
 	}
 
 	printf("\nTodos los resultados guardados en: %s\n", nombre_archivo);
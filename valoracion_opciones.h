@@ -0,0 +1,158 @@
+/******************************************************************************
+ * VALORACIÓN DE OPCIONES POR MONTE CARLO (BLACK-SCHOLES)
+ *****************************************************************************
+ *
+ * Carga de trabajo más parecida a los trabajos reales que el cálculo de π: cada
+ * muestra es un camino del subyacente (movimiento browniano geométrico) con
+ * varios pasos, una normal por paso y una exponencial por camino.
+ *
+ * Usa el reparto del integrador genérico (sumar_por_bloques y combinar_bloques
+ * de integrador_montecarlo.h):
+ *   - Bloques de MUESTRAS_POR_BLOQUE caminos, con el generador de cada bloque
+ *     sembrado con (semilla, bloque)
+ *   - Reparto de bloques con schedule(dynamic) y sumas combinadas en orden de
+ *     bloque, así que el precio es idéntico con cualquier número de hilos
+ *
+ * Dentro de un bloque los caminos se simulan en lotes de CAMINOS_LOTE_OPCION:
+ * en cada paso se generan las normales de todo el lote (Box-Muller o Ziggurat,
+ * ver normales.h) y se avanzan todos los caminos a la vez (bucle sin
+ * dependencias entre caminos, vectorizable).
+ *
+ * Contratos (call, con los precios exactos para comprobar el resultado):
+ *   - Europea: pago max(S_T - K, 0). Precio exacto de Black-Scholes
+ *   - Asiática geométrica: pago max(G - K, 0), con G la media geométrica de S en
+ *     los 'pasos' instantes T/pasos, 2T/pasos, ..., T. Como log G es normal, el
+ *     precio exacto tiene la misma forma que el de Black-Scholes
+ */
+
+#pragma once
+
+#include <math.h>
+#include <vector>
+#include <omp.h>
+#include "nucleos_montecarlo.h"      // Bloques, siembra, conversión de palabras y generadores
+#include "integrador_montecarlo.h"   // PoliticaIntegracion y ResultadoIntegral
+#include "normales.h"                // Box-Muller y Ziggurat por lotes
+
+enum TipoOpcion { OPCION_EUROPEA, OPCION_ASIATICA, NUM_TIPOS_OPCION };
+const char* const NOMBRES_OPCION[] = { "europea", "asiatica" };
+
+// Caminos que se avanzan juntos dentro de un bloque
+const int CAMINOS_LOTE_OPCION = 128;
+
+struct ContratoOpcion {
+	int tipo = OPCION_EUROPEA;
+	double spot = 100.0;         // Precio inicial del subyacente
+	double strike = 100.0;       // Precio de ejercicio
+	double tasa = 0.05;          // Tipo de interés libre de riesgo (continuo, anual)
+	double volatilidad = 0.2;    // Volatilidad anual
+	double vencimiento = 1.0;    // Años
+	int pasos = 12;              // Instantes de observación de la asiática (la europea usa 1)
+};
+
+// Función de distribución de la normal estándar
+inline double distribucion_normal(double x) {
+	return 0.5 * erfc(-x / sqrt(2.0));
+}
+
+/**
+ * Precio de una call cuyo subyacente en el vencimiento es lognormal: log X con
+ * media 'media' y desviación 'desviacion', descontado a la tasa del contrato
+ */
+inline double precio_call_lognormal(double media, double desviacion, double strike,
+	double descuento) {
+	double d2 = (media - log(strike)) / desviacion;
+	double d1 = d2 + desviacion;
+	double esperanza = exp(media + 0.5 * desviacion * desviacion);
+	return descuento * (esperanza * distribucion_normal(d1) - strike * distribucion_normal(d2));
+}
+
+/**
+ * Precio exacto del contrato (Black-Scholes o asiática geométrica discreta)
+ */
+inline double precio_exacto_opcion(const ContratoOpcion& c) {
+	double descuento = exp(-c.tasa * c.vencimiento);
+	double deriva = c.tasa - 0.5 * c.volatilidad * c.volatilidad;
+	if (c.tipo == OPCION_EUROPEA) {
+		return precio_call_lognormal(log(c.spot) + deriva * c.vencimiento,
+			c.volatilidad * sqrt(c.vencimiento), c.strike, descuento);
+	}
+	// log G = log S + deriva·T·(n+1)/(2n) + σ·(media de W en los n instantes), y
+	// la varianza de esa media es T·(n+1)(2n+1)/(6n²)
+	double n = c.pasos;
+	double media = log(c.spot) + deriva * c.vencimiento * (n + 1) / (2 * n);
+	double varianza = c.volatilidad * c.volatilidad * c.vencimiento * (n + 1) * (2 * n + 1) / (6 * n * n);
+	return precio_call_lognormal(media, sqrt(varianza), c.strike, descuento);
+}
+
+/**
+ * Suma el pago descontado y su cuadrado en los n primeros caminos de un bloque
+ */
+template <class Motor>
+inline void simular_bloque_opcion(const ContratoOpcion& c, int metodo_normal,
+	unsigned long long semilla, long long bloque, long long n, double& suma, double& suma_cuadrados) {
+	Motor gen;
+	sembrar_bloque(gen, semilla, bloque);
+
+	const bool europea = c.tipo == OPCION_EUROPEA;
+	const int pasos = europea ? 1 : c.pasos;
+	const double dt = c.vencimiento / pasos;
+	const double deriva = (c.tasa - 0.5 * c.volatilidad * c.volatilidad) * dt;
+	const double difusion = c.volatilidad * sqrt(dt);
+	const double descuento = exp(-c.tasa * c.vencimiento);
+	const double log_spot = log(c.spot);
+
+	double normales[CAMINOS_LOTE_OPCION];
+	double log_precio[CAMINOS_LOTE_OPCION];
+	double suma_log[CAMINOS_LOTE_OPCION];
+
+	suma = 0.0;
+	suma_cuadrados = 0.0;
+	for (long long hecho = 0; hecho < n; ) {
+		int lote = n - hecho < CAMINOS_LOTE_OPCION ? (int)(n - hecho) : CAMINOS_LOTE_OPCION;
+		for (int k = 0; k < lote; ++k) {
+			log_precio[k] = log_spot;
+			suma_log[k] = 0.0;
+		}
+		for (int p = 0; p < pasos; ++p) {
+			generar_normales(metodo_normal, gen, normales, lote);
+			for (int k = 0; k < lote; ++k) {
+				log_precio[k] += deriva + difusion * normales[k];
+				suma_log[k] += log_precio[k];
+			}
+		}
+		for (int k = 0; k < lote; ++k) {
+			double subyacente = exp(europea ? log_precio[k] : suma_log[k] / pasos);
+			double pago = subyacente > c.strike ? descuento * (subyacente - c.strike) : 0.0;
+			suma += pago;
+			suma_cuadrados += pago * pago;
+		}
+		hecho += lote;
+	}
+}
+
+/**
+ * Estima el precio del contrato
+ *
+ * @tparam Motor: Generador (std::mt19937 por defecto, o cualquiera de generadores.h)
+ * @param contrato: Tipo de opción y parámetros del modelo
+ * @param caminos: Número de caminos simulados
+ * @param politica: Hilos, reparto y semilla
+ * @param metodo_normal: Generación de las normales (MetodoNormal)
+ * @return Precio (valor), error estándar, suma de pagos y tiempo
+ */
+template <class Motor = std::mt19937>
+ResultadoIntegral valorar_opcion(const ContratoOpcion& contrato, long long caminos,
+	const PoliticaIntegracion& politica, int metodo_normal = NORMAL_BOX_MULLER) {
+	long long bloques = (caminos + MUESTRAS_POR_BLOQUE - 1) / MUESTRAS_POR_BLOQUE;
+	unsigned long long semilla = politica.semilla;
+
+	double inicio = omp_get_wtime();
+	std::vector<SumasBloque> por_bloque = sumar_por_bloques<SumasBloque>(bloques, politica,
+		[&contrato, metodo_normal, semilla, caminos](long long b, SumasBloque& s) {
+			simular_bloque_opcion<Motor>(contrato, metodo_normal, semilla, b,
+				muestras_bloque(caminos, b), s.suma, s.suma_cuadrados);
+		});
+	SumasBloque total = combinar_bloques(por_bloque, 0, bloques);
+	return resultado_de_sumas(total, caminos, 1.0, omp_get_wtime() - inicio);
+}